@@ -0,0 +1,9 @@
+@echo off
+
+;rem move into the Example Directory
+set BATCHDIR=%~dp0%
+cd /d %BATCHDIR%
+
+python benchmark.py %*
+
+if not defined calledscript ( pause )
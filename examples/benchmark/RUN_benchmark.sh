@@ -0,0 +1,5 @@
+#!/bin/bash
+
+cd $(dirname $0)
+
+python3 benchmark.py "$@"
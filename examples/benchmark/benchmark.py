@@ -0,0 +1,309 @@
+#!/usr/bin/python3
+
+# Copyright Imperas Software Ltd
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#      http:#www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+#
+# Run the benchmark suite described in suite.json under fixed configurations,
+# collect simulator performance metrics as JSON and optionally compare them
+# against a stored baseline.
+#
+
+import argparse
+import json
+import os
+import platform
+import re
+import subprocess
+import sys
+import time
+
+RESULT_VERSION = 1
+
+#
+# Model parameters enabling the statistics reports parsed below
+#
+STATS_OVERRIDES = [
+    'riscvOVPsim/cpu/jit_stats=T',
+    'riscvOVPsim/cpu/tlb_stats=T',
+    'riscvOVPsim/cpu/trap_stats=T',
+]
+
+#
+# Metrics compared against the baseline: True if a higher value is better.
+# Default thresholds are percentages; deterministic counts default to zero
+# (any increase is a regression).
+#
+METRICS = {
+    'host_mips'           : True,
+    'translation_time_ms' : False,
+    'translated_blocks'   : False,
+    'retranslations'      : False,
+    'tlb_misses'          : False,
+    'traps'               : False,
+    'peak_rss_kb'         : False,
+}
+
+DEFAULT_THRESHOLDS = {
+    'host_mips'           : 5.0,
+    'translation_time_ms' : 20.0,
+    'translated_blocks'   : 0.0,
+    'retranslations'      : 0.0,
+    'tlb_misses'          : 0.0,
+    'traps'               : 0.0,
+    'peak_rss_kb'         : 10.0,
+}
+
+#
+# Patterns for values in simulator output (values for each hart are summed)
+#
+PATTERNS = {
+    'instructions'        : r'Simulated instructions:\s*([\d,]+)',
+    'elapsed_s'           : r'Elapsed time\s*:\s*([\d.]+) seconds',
+    'translated_blocks'   : r'blocks translated:\s*(\d+)',
+    'translation_time_ms' : r'translation time:\s*([\d.]+) ms',
+    'retranslations'      : r'retranslations:\s*(\d+)',
+    'tlb_misses'          : r'^\s*misses:\s*(\d+)',
+    'ptw_reads'           : r'page table walk reads:\s*(\d+)',
+    'traps'               : r'^\S+ mode: (\d+) traps',
+}
+
+
+def defaultSimulator():
+    root = os.path.dirname(os.path.dirname(os.path.dirname(
+        os.path.abspath(__file__)
+    )))
+    if platform.system()=='Windows':
+        return os.path.join(root, 'bin', 'Windows64', 'riscvOVPsim.exe')
+    else:
+        return os.path.join(root, 'bin', 'Linux64', 'riscvOVPsim.exe')
+
+
+def sumMatches(pattern, text):
+    total = 0
+    for match in re.findall(pattern, text, re.MULTILINE):
+        value = match.replace(',', '')
+        total += float(value) if '.' in value else int(value)
+    return total
+
+
+def runOnce(simulator, bench, suiteDir):
+    """Run one benchmark once, returning (output, wall seconds, peak RSS)"""
+
+    cwd = os.path.normpath(os.path.join(suiteDir, bench.get('dir', '.')))
+    cmd = [simulator, '--program', bench['program']]
+    for override in STATS_OVERRIDES:
+        cmd += ['--override', override]
+    cmd += bench.get('args', [])
+    if 'finishafter' in bench:
+        cmd += ['--finishafter', str(bench['finishafter'])]
+
+    start = time.time()
+    proc  = subprocess.Popen(
+        cmd, cwd=cwd, stdout=subprocess.PIPE, stderr=subprocess.STDOUT
+    )
+    output = proc.stdout.read().decode('utf-8', 'replace')
+    proc.stdout.close()
+
+    # wait4 gives the peak RSS of this child alone (not available on Windows)
+    rss = None
+    if hasattr(os, 'wait4'):
+        _, status, usage = os.wait4(proc.pid, 0)
+        proc.returncode  = os.waitstatus_to_exitcode(status) \
+            if hasattr(os, 'waitstatus_to_exitcode') else status
+        rss = usage.ru_maxrss
+        if platform.system()=='Darwin':
+            rss //= 1024
+    else:
+        proc.wait()
+    wall = time.time()-start
+
+    if proc.returncode:
+        sys.stderr.write(output)
+        sys.exit('%s: simulator exited with status %d' % (
+            bench['name'], proc.returncode
+        ))
+
+    return output, wall, rss
+
+
+def runBenchmark(simulator, bench, suiteDir, repeat):
+    """Run one benchmark, taking timing metrics from the fastest repeat"""
+
+    best = None
+
+    for i in range(repeat):
+
+        output, wall, rss = runOnce(simulator, bench, suiteDir)
+        result = {key : sumMatches(p, output) for key, p in PATTERNS.items()}
+
+        result['wall_s']      = round(wall, 3)
+        result['peak_rss_kb'] = rss
+
+        if not best or (result['wall_s']<best['wall_s']):
+            best = result
+
+    instructions = best['instructions']
+    seconds      = best['elapsed_s'] or best['wall_s']
+
+    best['host_mips'] = round(instructions/seconds/1e6, 1) if seconds else 0
+    best['tlb_misses_per_kinst'] = round(
+        1000.0*best['tlb_misses']/instructions, 4
+    ) if instructions else 0
+    best['traps_per_kinst'] = round(
+        1000.0*best['traps']/instructions, 4
+    ) if instructions else 0
+
+    return best
+
+
+def compare(results, baseline, thresholds):
+    """Compare results with baseline, returning list of regression messages"""
+
+    failures = []
+
+    for name, result in sorted(results.items()):
+
+        base = baseline.get('results', {}).get(name)
+
+        if not base:
+            print('%-24s no baseline' % name)
+            continue
+
+        if result['instructions']!=base['instructions']:
+            failures.append(
+                '%s: instruction count changed (%d -> %d)' % (
+                    name, base['instructions'], result['instructions']
+                )
+            )
+
+        for metric, higherBetter in METRICS.items():
+
+            old = base.get(metric)
+            new = result.get(metric)
+
+            if old is None or new is None:
+                continue
+
+            limit  = thresholds[metric]
+            change = 100.0*(new-old)/old if old else (100.0 if new else 0.0)
+            worse  = -change if higherBetter else change
+            status = 'REGRESSION' if worse>limit else 'ok'
+
+            print('%-24s %-20s %14s %14s %+8.1f%% %s' % (
+                name, metric, old, new, change, status
+            ))
+
+            if worse>limit:
+                failures.append(
+                    '%s: %s %s -> %s (%+.1f%%, limit %.1f%%)' % (
+                        name, metric, old, new, change, limit
+                    )
+                )
+
+    return failures
+
+
+def parseThresholds(specs):
+
+    thresholds = dict(DEFAULT_THRESHOLDS)
+
+    for spec in specs:
+        metric, _, value = spec.partition('=')
+        if metric not in METRICS or not value:
+            sys.exit('invalid threshold "%s" (expected METRIC=PERCENT with '
+                     'METRIC one of %s)' % (spec, ', '.join(METRICS)))
+        thresholds[metric] = float(value)
+
+    return thresholds
+
+
+def main():
+
+    here   = os.path.dirname(os.path.abspath(__file__))
+    parser = argparse.ArgumentParser(
+        description='Run the riscvOVPsim benchmark suite'
+    )
+    parser.add_argument('--suite', default=os.path.join(here, 'suite.json'),
+        help='suite description (default: suite.json)')
+    parser.add_argument('--simulator', default=defaultSimulator(),
+        help='simulator executable')
+    parser.add_argument('--output', default='results.json',
+        help='file to write results to (default: results.json)')
+    parser.add_argument('--baseline',
+        help='baseline results to compare against')
+    parser.add_argument('--threshold', action='append', default=[],
+        metavar='METRIC=PERCENT',
+        help='allowed regression for a metric (may be repeated)')
+    parser.add_argument('--repeat', type=int, default=3,
+        help='runs of each benchmark; the fastest is reported (default: 3)')
+    parser.add_argument('--only', action='append', default=[],
+        metavar='NAME', help='run only the named benchmark (may be repeated)')
+    args = parser.parse_args()
+
+    thresholds = parseThresholds(args.threshold)
+
+    with open(args.suite) as f:
+        suite = json.load(f)
+
+    suiteDir = os.path.dirname(os.path.abspath(args.suite))
+    results  = {}
+
+    for bench in suite['benchmarks']:
+
+        if args.only and bench['name'] not in args.only:
+            continue
+
+        print('running %s...' % bench['name'])
+        sys.stdout.flush()
+
+        results[bench['name']] = runBenchmark(
+            args.simulator, bench, suiteDir, max(1, args.repeat)
+        )
+
+    report = {
+        'version'   : RESULT_VERSION,
+        'host'      : platform.node(),
+        'platform'  : platform.platform(),
+        'simulator' : os.path.abspath(args.simulator),
+        'results'   : results,
+    }
+
+    with open(args.output, 'w') as f:
+        json.dump(report, f, indent=2, sort_keys=True)
+        f.write('\n')
+
+    print('results written to %s' % args.output)
+
+    if args.baseline:
+
+        with open(args.baseline) as f:
+            baseline = json.load(f)
+
+        if baseline.get('version')!=RESULT_VERSION:
+            sys.exit('baseline %s has incompatible version' % args.baseline)
+
+        failures = compare(results, baseline, thresholds)
+
+        if failures:
+            print('\n%d regression(s):' % len(failures))
+            for failure in failures:
+                print('  ' + failure)
+            sys.exit(1)
+
+        print('\nno regressions')
+
+
+if __name__ == '__main__':
+    main()
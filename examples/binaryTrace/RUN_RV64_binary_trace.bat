@@ -0,0 +1,15 @@
+@echo off
+
+;rem move into the Example Directory
+set BATCHDIR=%~dp0%
+cd /d %BATCHDIR%
+
+..\..\bin\Windows64\riscvOVPsim.exe ^
+    --program ..\fibonacci\fibonacci.RISCV64.elf ^
+    --variant RVB64I ^
+    --override riscvOVPsim/cpu/add_Extensions=MACSU ^
+    --override riscvOVPsim/cpu/binary_trace=fib.trace ^
+    --finishafter 100000 ^
+    %*
+
+if not defined calledscript ( pause )
@@ -0,0 +1,12 @@
+#!/bin/bash
+
+cd $(dirname $0)
+bindir=$(dirname $(dirname $(pwd)))/bin/Linux64
+
+${bindir}/riscvOVPsim.exe \
+    --program ../fibonacci/fibonacci.RISCV64.elf \
+    --variant RVB64I \
+    --override riscvOVPsim/cpu/add_Extensions=MACSU \
+    --override riscvOVPsim/cpu/binary_trace=fib.trace \
+    --finishafter 100000 \
+    "$@"
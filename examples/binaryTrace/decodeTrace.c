@@ -0,0 +1,239 @@
+/*
+ * Copyright (c) 2005-2020 Imperas Software Ltd., www.imperas.com
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied.
+ *
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+//
+// Decoder for the binary instruction trace written by the riscvOVPsim model
+// when parameter binary_trace is set. The trace is expanded to text in the
+// style of the simulator instruction and register-change trace (instruction
+// address and word, followed by changed registers with old and new values and
+// any memory access address). Instructions that took an exception and did not
+// complete are marked.
+//
+// Build:  gcc -O2 -o decodeTrace decodeTrace.c
+// Usage:  decodeTrace <trace file> [<hart name>]
+//
+// The record format is described in source/riscvBinaryTrace.h.
+//
+
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+
+#define RVBT_MAGIC          "RVBT"
+#define RVBT_VERSION        2
+#define RVBT_F_COMPRESSED   0x01
+#define RVBT_F_JUMP         0x02
+#define RVBT_F_REG          0x04
+#define RVBT_F_MEM          0x08
+#define RVBT_F_EXCEPT       0x10
+#define RVBT_REG_MORE       0x80
+
+static const char *abiNames[32] = {
+    "zero", "ra", "sp",  "gp",  "tp", "t0", "t1", "t2",
+    "s0",   "s1", "a0",  "a1",  "a2", "a3", "a4", "a5",
+    "a6",   "a7", "s2",  "s3",  "s4", "s5", "s6", "s7",
+    "s8",   "s9", "s10", "s11", "t3", "t4", "t5", "t6"
+};
+
+//
+// Read one byte, returning 0 at end of file
+//
+static int getByte(FILE *file, uint8_t *value) {
+
+    int c = fgetc(file);
+
+    if(c==EOF) {
+        return 0;
+    }
+
+    *value = c;
+
+    return 1;
+}
+
+//
+// Read an unsigned varint, returning 0 at end of file
+//
+static int getVarint(FILE *file, uint64_t *value) {
+
+    uint64_t result = 0;
+    unsigned shift  = 0;
+    uint8_t  byte;
+
+    do {
+
+        if(!getByte(file, &byte)) {
+            return 0;
+        }
+
+        result |= (uint64_t)(byte & 0x7f) << shift;
+        shift  += 7;
+
+    } while(byte & 0x80);
+
+    *value = result;
+
+    return 1;
+}
+
+//
+// Read a zigzag-encoded signed varint, returning 0 at end of file
+//
+static int getSigned(FILE *file, int64_t *value) {
+
+    uint64_t raw;
+
+    if(!getVarint(file, &raw)) {
+        return 0;
+    }
+
+    *value = (int64_t)(raw>>1) ^ -(int64_t)(raw&1);
+
+    return 1;
+}
+
+int main(int argc, char *argv[]) {
+
+    const char *hart     = (argc>2) ? argv[2] : "riscvOVPsim/cpu";
+    uint64_t    regs[32] = {0};
+    uint64_t    nextPC   = 0;
+    uint64_t    address  = 0;
+    uint64_t    mask;
+    uint64_t    records  = 0;
+    int         digits;
+    char        magic[4];
+    uint8_t     version;
+    uint8_t     XLEN;
+    uint8_t     flags;
+    FILE       *file;
+
+    if(argc<2) {
+        fprintf(stderr, "usage: %s <trace file> [<hart name>]\n", argv[0]);
+        return 1;
+    }
+
+    if(!(file=fopen(argv[1], "rb"))) {
+        fprintf(stderr, "cannot open '%s'\n", argv[1]);
+        return 1;
+    }
+
+    // validate file header
+    if(
+        (fread(magic, 1, 4, file)!=4)         ||
+        memcmp(magic, RVBT_MAGIC, 4)          ||
+        !getByte(file, &version)              ||
+        (version!=RVBT_VERSION)               ||
+        !getByte(file, &XLEN)                 ||
+        ((XLEN!=32) && (XLEN!=64))
+    ) {
+        fprintf(stderr, "'%s' is not a binary trace file\n", argv[1]);
+        return 1;
+    }
+
+    mask   = (XLEN==64) ? ~(uint64_t)0 : (((uint64_t)1<<XLEN)-1);
+    digits = XLEN/4;
+
+    while(getByte(file, &flags)) {
+
+        uint64_t pc = nextPC;
+        uint32_t instruction;
+        uint8_t  bytes[4] = {0};
+        int      size     = (flags & RVBT_F_COMPRESSED) ? 2 : 4;
+
+        // instruction address
+        if(flags & RVBT_F_JUMP) {
+
+            int64_t delta;
+
+            if(!getSigned(file, &delta)) {
+                break;
+            }
+
+            pc = (pc+delta) & mask;
+        }
+
+        // instruction word
+        if(fread(bytes, 1, size, file)!=(size_t)size) {
+            break;
+        }
+
+        instruction = bytes[0] | (bytes[1]<<8) |
+                      ((uint32_t)bytes[2]<<16) | ((uint32_t)bytes[3]<<24);
+
+        printf(
+            "Info '%s', 0x%0*llx: %0*x\n",
+            hart, digits, (unsigned long long)pc, size*2, instruction
+        );
+
+        // changed registers
+        if(flags & RVBT_F_REG) {
+
+            uint8_t index;
+
+            do {
+
+                uint64_t value;
+
+                if(!getByte(file, &index) || !getVarint(file, &value)) {
+                    break;
+                }
+
+                printf(
+                    "Info   %-4s %0*llx -> %0*llx\n",
+                    abiNames[index & 31],
+                    digits, (unsigned long long)regs[index & 31],
+                    digits, (unsigned long long)value
+                );
+
+                regs[index & 31] = value;
+
+            } while(index & RVBT_REG_MORE);
+        }
+
+        // memory address
+        if(flags & RVBT_F_MEM) {
+
+            int64_t delta;
+
+            if(!getSigned(file, &delta)) {
+                break;
+            }
+
+            address = (address+delta) & mask;
+
+            printf(
+                "Info   mem  %0*llx\n", digits, (unsigned long long)address
+            );
+        }
+
+        // exception (instruction did not complete)
+        if(flags & RVBT_F_EXCEPT) {
+            printf("Info   exception\n");
+        }
+
+        nextPC = (pc+size) & mask;
+        records++;
+    }
+
+    fclose(file);
+
+    fprintf(stderr, "%llu records decoded\n", (unsigned long long)records);
+
+    return 0;
+}
@@ -0,0 +1,334 @@
+/*
+ * Copyright (c) 2005-2020 Imperas Software Ltd., www.imperas.com
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied.
+ *
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+// standard header files
+#include <stdio.h>
+#include <string.h>
+
+// Imperas header files
+#include "hostapi/impAlloc.h"
+
+// VMI header files
+#include "vmi/vmiMessage.h"
+#include "vmi/vmiRt.h"
+
+// model header files
+#include "riscvBinaryTrace.h"
+#include "riscvMessage.h"
+#include "riscvStructure.h"
+#include "riscvUtils.h"
+
+
+////////////////////////////////////////////////////////////////////////////////
+// BINARY TRACE STATE
+////////////////////////////////////////////////////////////////////////////////
+
+//
+// Size of the record buffer written to the trace file when full
+//
+#define RVBT_BUFFER_BYTES   (1<<20)
+
+//
+// Upper bound on the size of one encoded record (flags, PC delta, instruction,
+// 31 changed registers and memory address)
+//
+#define RVBT_RECORD_BYTES   512
+
+//
+// This holds binary instruction trace state for a hart
+//
+typedef struct riscvBinaryTraceS {
+
+    // output file and buffer
+    FILE  *file;                    // trace file
+    Uns8  *buffer;                  // encoded record buffer
+    Uns32  used;                    // bytes used in buffer
+    Uns64  records;                 // total records written
+
+    // encoder state
+    Uns64  mask;                    // XLEN mask for values and addresses
+    Uns64  nextPC;                  // address following previous instruction
+    Uns64  lastAddress;             // previous memory address
+    Uns64  shadow[32];              // X register values at previous record
+
+    // record for the current instruction (completed at the next instruction)
+    Uns64  thisPC;                  // instruction address
+    Uns64  address;                 // memory access address
+    Uns32  instruction;             // instruction word
+    Uns8   bytes;                   // instruction size
+    Bool   pending;                 // whether record is pending
+    Bool   hasAddress;              // whether memory address is valid
+    Bool   exception;               // whether instruction took an exception
+
+} riscvBinaryTrace;
+
+
+////////////////////////////////////////////////////////////////////////////////
+// ENCODING
+////////////////////////////////////////////////////////////////////////////////
+
+//
+// Write the record buffer to the trace file
+//
+static void flushBuffer(riscvBinaryTraceP trace) {
+
+    if(trace->used) {
+        fwrite(trace->buffer, 1, trace->used, trace->file);
+        trace->used = 0;
+    }
+}
+
+//
+// Append a byte to the record buffer
+//
+inline static void putByte(riscvBinaryTraceP trace, Uns8 value) {
+    trace->buffer[trace->used++] = value;
+}
+
+//
+// Append an unsigned varint to the record buffer
+//
+static void putVarint(riscvBinaryTraceP trace, Uns64 value) {
+
+    while(value>=0x80) {
+        putByte(trace, value|0x80);
+        value >>= 7;
+    }
+
+    putByte(trace, value);
+}
+
+//
+// Append a zigzag-encoded signed varint to the record buffer
+//
+inline static void putSigned(riscvBinaryTraceP trace, Int64 value) {
+    putVarint(trace, (value<<1) ^ (value>>63));
+}
+
+//
+// Append the pending record to the record buffer, using the X register
+// values now that the instruction has completed
+//
+static void completeRecord(riscvP riscv, riscvBinaryTraceP trace) {
+
+    Uns64 mask    = trace->mask;
+    Uns32 changed = 0;
+    Uns8  flags   = 0;
+    Uns32 i;
+
+    // find X registers changed by the instruction
+    for(i=1; i<32; i++) {
+        if(trace->shadow[i]!=(riscv->x[i] & mask)) {
+            changed |= (1<<i);
+        }
+    }
+
+    // compose record flags
+    if(trace->bytes==2) {
+        flags |= RVBT_F_COMPRESSED;
+    }
+    if(trace->thisPC!=trace->nextPC) {
+        flags |= RVBT_F_JUMP;
+    }
+    if(changed) {
+        flags |= RVBT_F_REG;
+    }
+    if(trace->hasAddress) {
+        flags |= RVBT_F_MEM;
+    }
+    if(trace->exception) {
+        flags |= RVBT_F_EXCEPT;
+    }
+
+    // flush buffer if there may be insufficient space for the record
+    if(trace->used>(RVBT_BUFFER_BYTES-RVBT_RECORD_BYTES)) {
+        flushBuffer(trace);
+    }
+
+    putByte(trace, flags);
+
+    // PC delta
+    if(flags & RVBT_F_JUMP) {
+        putSigned(trace, trace->thisPC-trace->nextPC);
+    }
+
+    // instruction word
+    putByte(trace, trace->instruction);
+    putByte(trace, trace->instruction>>8);
+
+    if(!(flags & RVBT_F_COMPRESSED)) {
+        putByte(trace, trace->instruction>>16);
+        putByte(trace, trace->instruction>>24);
+    }
+
+    // changed X registers
+    while(changed) {
+
+        Uns32 index = __builtin_ctz(changed);
+        Uns64 value = riscv->x[index] & mask;
+
+        changed &= changed-1;
+
+        putByte(trace, index | (changed ? RVBT_REG_MORE : 0));
+        putVarint(trace, value);
+
+        trace->shadow[index] = value;
+    }
+
+    // memory address
+    if(flags & RVBT_F_MEM) {
+        putSigned(trace, trace->address-trace->lastAddress);
+        trace->lastAddress = trace->address;
+    }
+
+    trace->nextPC  = (trace->thisPC+trace->bytes) & mask;
+    trace->pending = False;
+    trace->records++;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+// PUBLIC INTERFACE
+////////////////////////////////////////////////////////////////////////////////
+
+//
+// Open the binary instruction trace file if enabled (each hart writes a file
+// named with the hart name appended)
+//
+void riscvNewBinaryTrace(riscvP riscv) {
+
+    const char *base = riscv->configInfo.binary_trace;
+
+    if(base && base[0]) {
+
+        const char *hart = vmirtProcessorName((vmiProcessorP)riscv);
+        char        name[strlen(base)+strlen(hart)+2];
+        FILE       *file;
+
+        sprintf(name, "%s.%s", base, hart);
+
+        if(!(file=fopen(name, "wb"))) {
+
+            vmiMessage("W", CPU_PREFIX "_BTO",
+                "Cannot open binary trace file '%s'", name
+            );
+
+        } else {
+
+            riscvBinaryTraceP trace = STYPE_CALLOC(riscvBinaryTrace);
+            Uns32             XLEN  = riscvGetXlenArch(riscv);
+
+            trace->file   = file;
+            trace->buffer = STYPE_CALLOC_N(Uns8, RVBT_BUFFER_BYTES);
+            trace->mask   = (XLEN==64) ? -1ULL : ((1ULL<<XLEN)-1);
+
+            // write file header
+            fwrite(RVBT_MAGIC, 1, 4, file);
+            fputc(RVBT_VERSION, file);
+            fputc(XLEN, file);
+
+            riscv->binaryTrace = trace;
+        }
+    }
+}
+
+//
+// Complete and close the binary instruction trace file
+//
+void riscvFreeBinaryTrace(riscvP riscv) {
+
+    riscvBinaryTraceP trace = riscv->binaryTrace;
+
+    if(trace) {
+
+        // complete any record for the last executed instruction
+        if(trace->pending) {
+            completeRecord(riscv, trace);
+        }
+
+        flushBuffer(trace);
+        fclose(trace->file);
+
+        vmiMessage("I", CPU_PREFIX "_BTW",
+            "Binary trace of "FMT_64u" instructions written for %s",
+            trace->records, vmirtProcessorName((vmiProcessorP)riscv)
+        );
+
+        STYPE_FREE(trace->buffer);
+        STYPE_FREE(trace);
+
+        riscv->binaryTrace = 0;
+    }
+}
+
+//
+// Record execution of an instruction (called from JIT code)
+//
+void riscvBinaryTraceInstruction(
+    riscvP riscv,
+    Uns64  thisPC,
+    Uns32  instruction,
+    Uns32  bytes
+) {
+    riscvBinaryTraceP trace = riscv->binaryTrace;
+
+    // complete record for the previous instruction
+    if(trace->pending) {
+        completeRecord(riscv, trace);
+    }
+
+    // start record for this instruction
+    trace->thisPC      = thisPC & trace->mask;
+    trace->instruction = instruction;
+    trace->bytes       = bytes;
+    trace->hasAddress  = False;
+    trace->exception   = False;
+    trace->pending     = True;
+}
+
+//
+// Record the address of a memory access by the current instruction (called
+// from JIT code). Only the first access is recorded: for vector loads and
+// stores this is the first active element.
+//
+void riscvBinaryTraceAddress(riscvP riscv, Uns64 base, Uns64 offset) {
+
+    riscvBinaryTraceP trace = riscv->binaryTrace;
+
+    if(!trace->hasAddress) {
+        trace->address    = (base+offset) & trace->mask;
+        trace->hasAddress = True;
+    }
+}
+
+//
+// Record that the instruction at the given address took a synchronous
+// exception. Exceptions taken on instruction fetch happen before the record
+// for the faulting instruction is started, so the pending record is marked
+// only if it is for the instruction at the exception address.
+//
+void riscvBinaryTraceException(riscvP riscv, Uns64 EPC) {
+
+    riscvBinaryTraceP trace = riscv->binaryTrace;
+
+    if(trace->pending && (trace->thisPC==(EPC & trace->mask))) {
+        trace->exception = True;
+    }
+}
+
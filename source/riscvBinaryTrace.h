@@ -0,0 +1,99 @@
+/*
+ * Copyright (c) 2005-2020 Imperas Software Ltd., www.imperas.com
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied.
+ *
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#pragma once
+
+// VMI header files
+#include "vmi/vmiTypes.h"
+
+// model header files
+#include "riscvTypeRefs.h"
+
+//
+// Binary instruction trace file format
+// ------------------------------------
+// The file starts with a header of the four characters "RVBT", a version byte
+// (RVBT_VERSION) and a byte holding the XLEN of the traced hart. This is
+// followed by one record for each executed instruction:
+//
+//   Uns8    flags (RVBT_F_*)
+//   varint  PC delta (only if RVBT_F_JUMP is set): signed difference between
+//           the instruction address and the address following the previous
+//           instruction, zigzag-encoded
+//   Uns16/  instruction word (Uns16 if RVBT_F_COMPRESSED is set, otherwise
+//   Uns32   Uns32)
+//   ...     changed X registers (only if RVBT_F_REG is set): for each, a byte
+//           holding the register index (bit 7 set if another register
+//           follows) and a varint holding the new value
+//   varint  memory address (only if RVBT_F_MEM is set): signed difference
+//           from the previous memory address, zigzag-encoded
+//
+// If the instruction takes a synchronous exception (other than ECALL or
+// EBREAK) it does not complete, and flag RVBT_F_EXCEPT is set in its record.
+// Any memory address is then the address of the faulting access. An
+// instruction retried after the exception handler returns has a second record.
+//
+// The memory address is that of the first access made by the instruction. For
+// vector loads and stores, this is the address of the first active element.
+//
+// All multi-byte fixed-size fields are little-endian. A varint holds seven
+// bits per byte, least-significant first, with bit 7 set in all bytes but
+// the last. The PC of the first record is a delta from address 0.
+//
+#define RVBT_MAGIC          "RVBT"
+#define RVBT_VERSION        2
+#define RVBT_F_COMPRESSED   0x01
+#define RVBT_F_JUMP         0x02
+#define RVBT_F_REG          0x04
+#define RVBT_F_MEM          0x08
+#define RVBT_F_EXCEPT       0x10
+#define RVBT_REG_MORE       0x80
+
+//
+// Open the binary instruction trace file if enabled
+//
+void riscvNewBinaryTrace(riscvP riscv);
+
+//
+// Complete and close the binary instruction trace file
+//
+void riscvFreeBinaryTrace(riscvP riscv);
+
+//
+// Record execution of an instruction (called from JIT code)
+//
+void riscvBinaryTraceInstruction(
+    riscvP riscv,
+    Uns64  thisPC,
+    Uns32  instruction,
+    Uns32  bytes
+);
+
+//
+// Record the address of a memory access by the current instruction (called
+// from JIT code)
+//
+void riscvBinaryTraceAddress(riscvP riscv, Uns64 base, Uns64 offset);
+
+//
+// Record that the instruction at the given address took a synchronous
+// exception
+//
+void riscvBinaryTraceException(riscvP riscv, Uns64 EPC);
+
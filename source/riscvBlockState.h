@@ -59,6 +59,18 @@ typedef enum riscvVLClassE {
     VLCLASSMT_MAX     = 3,
 } riscvVLClassMt;
 
+//
+// This indicates the known active fixed point rounding mode (vxrm), offset by
+// one so that zero indicates an unknown mode
+//
+typedef enum riscvVXRMMtE {
+    VXRMMT_UNKNOWN = 0,
+    VXRMMT_RNU     = 1,
+    VXRMMT_RNE     = 2,
+    VXRMMT_RDN     = 3,
+    VXRMMT_ROD     = 4,
+} riscvVXRMMt;
+
 //
 // This indicates the VLMUL for which a vector register is known to have top
 // zero (either a single register, or a component of a group)
@@ -68,15 +80,32 @@ typedef enum riscvTZE {
     VTZ_GROUP,
 } riscvTZ;
 
+//
+// This indicates the base registers used by loads in the current block (for
+// spin-wait loop detection)
+//
+typedef enum riscvSpinLoadE {
+    SPIN_LOAD_NONE,                 // no load in block
+    SPIN_LOAD_SAME,                 // all loads use base register spinBase
+    SPIN_LOAD_VARIES,               // loads use different or unknown bases
+} riscvSpinLoad;
+
 //
 // This subdivides the polymorphic key into parts used by the vector extension
-// and transaction mode
+// (vtype/vl and vxrm), Debug mode single-step and transaction mode
 //
 typedef enum riscvPMKE {
     PMK_VECTOR      = 0x00ff,
+    PMK_VXRM        = 0x0300,
+    PMK_STEP        = 0x4000,
     PMK_TRANSACTION = 0x8000,
 } riscvPMK;
 
+//
+// Shift to vxrm field in polymorphic key
+//
+#define PMK_VXRM_SHIFT 8
+
 //
 // This structure holds state for a code block as it is morphed
 //
@@ -89,8 +118,14 @@ typedef struct riscvBlockStateS {
     riscvSEWMt       SEWMt;         // known active vector SEW
     riscvVLMULMt     VLMULMt;       // known active vector VLMUL
     riscvVLClassMt   VLClassMt;     // known active vector VL zero/non-zero/max
+    riscvVXRMMt      VXRMMt;        // known active fixed point rounding mode
     Uns32            VZeroTopMt[2]; // known vector registers with zero top
     Bool             VStartZeroMt;  // vstart known to be zero?
+    Uns64            startPC;       // address of first block instruction
+    Bool             startPCValid;  // is startPC valid?
+    riscvSpinLoad    spinLoad;      // base registers used by block loads
+    Uns8             spinBase;      // load base register index (if same)
+    Bool             storeSeen;     // has block contained a store?
 
 } riscvBlockState;
 
@@ -202,7 +202,7 @@ static vmiFPRC updateCurrentRMValid(riscvP riscv) {
         // enable rounding mode valid state check if required
         if(!riscv->rmCheckValid) {
             riscv->rmCheckValid = True;
-            vmirtFlushAllDicts(processor);
+            riscvFlushAllDicts(riscv);
         }
 
         // update state to reflect invalid RM change
@@ -415,6 +415,9 @@ static RISCV_CSR_WRITEFN(fcsrW) {
 
         // update fixed point rounding mode alias
         WR_CSR_FIELD(riscv, vxrm, rm, RD_CSR_FIELD(riscv, fcsr, vxrm));
+
+        // set matching polymorphic key
+        riscvRefreshVectorPMKey(riscv);
     }
 
     // return written value
@@ -497,13 +500,11 @@ static void consolidateFPFlags(riscvP riscv) {
 //
 static void updateEndian(riscvP riscv) {
 
-    vmiProcessorP processor = (vmiProcessorP)riscv;
-
     // if this is the first time endianness has been changed, flush all
     // dictionaries (endianness checking is required)
     if(!riscv->checkEndian) {
         riscv->checkEndian = True;
-        vmirtFlushAllDicts(processor);
+        riscvFlushAllDicts(riscv);
     }
 }
 
@@ -597,6 +598,8 @@ static void statusW(riscvP riscv, Uns64 newValue, Uns64 mask) {
     // handle and exceptions that have been enabled
     if(newIE & ~oldIE) {
         riscvTestInterrupt(riscv);
+    } else if(newIE != oldIE) {
+        riscvRefreshPendingAndEnabled(riscv);
     }
 }
 
@@ -782,6 +785,9 @@ static Uns64 ipR(riscvP riscv, Uns64 rMask, Bool isWrite, Bool useCLIC) {
 
     Uns64 result = riscv->swip;
 
+    // apply any batched interrupt net changes
+    riscvFlushPending(riscv);
+
     // in save/restore mode, return raw software-writable value
     if(riscv->inSaveRestore) {
         // no action
@@ -1002,6 +1008,7 @@ static RISCV_CSR_WRITEFN(midelegW) {
 
     // handle any interrupts that are now pending and enabled
     if(oldValue!=newValue) {
+        riscvRefreshInterruptDelegation(riscv);
         riscvTestInterrupt(riscv);
     }
 
@@ -1025,6 +1032,7 @@ static RISCV_CSR_WRITEFN(sidelegW) {
 
     // handle any interrupts that are now pending and enabled
     if(oldValue!=newValue) {
+        riscvRefreshInterruptDelegation(riscv);
         riscvTestInterrupt(riscv);
     }
 
@@ -1492,6 +1500,103 @@ static RISCV_CSR_WRITEFN(minstrethW) {
     return newValue;
 }
 
+//
+// Classify performance monitor CSRs by number (mhpmevent3-31 are at
+// 0x323-0x33F; the upper halves of counters have bit 7 set)
+//
+#define HPM_IS_EVENT(_NUM)  (((_NUM) & ~31)==0x320)
+#define HPM_IS_HIGH(_NUM)   ((_NUM) & 0x80)
+
+//
+// Is the indexed performance monitor counter inhibited?
+//
+inline static Bool hpmInhibited(riscvP riscv, Uns32 index) {
+    return (RD_CSR(riscv, mcountinhibit) >> index) & 1;
+}
+
+//
+// Read the indexed performance monitor counter (counters hold the count of
+// the selected event relative to a base value)
+//
+static Uns64 hpmCounterR(riscvP riscv, Uns32 index) {
+
+    if(hpmInhibited(riscv, index)) {
+        return riscv->hpmValue[index];
+    } else {
+        return riscv->hpmCount[riscv->hpmEvent[index]] - riscv->hpmBase[index];
+    }
+}
+
+//
+// Write the indexed performance monitor counter
+//
+static void hpmCounterW(riscvP riscv, Uns32 index, Uns64 value) {
+
+    riscv->hpmValue[index] = value;
+    riscv->hpmBase[index]  = riscv->hpmCount[riscv->hpmEvent[index]] - value;
+}
+
+//
+// Refresh the mask of selected performance monitor events, flushing
+// translations if the set of events counted by JIT-translated code changes
+//
+static void refreshHPMEvents(riscvP riscv) {
+
+    Uns32 oldMask = riscv->hpmEventMask;
+    Uns32 newMask = 0;
+    Uns32 i;
+
+    for(i=3; i<32; i++) {
+        newMask |= (1<<riscv->hpmEvent[i]);
+    }
+
+    newMask &= ~(1<<RV_HPM_NONE);
+
+    riscv->hpmEventMask = newMask;
+
+    if((oldMask^newMask) & RV_HPM_JIT_MASK) {
+        riscvFlushAllDicts(riscv);
+    }
+}
+
+//
+// Write the indexed performance monitor event selector (unsupported events
+// select no event)
+//
+static void hpmEventW(riscvP riscv, Uns32 index, Uns64 event) {
+
+    Uns64 value = hpmCounterR(riscv, index);
+
+    riscv->hpmEvent[index] = (event<RV_HPM_LAST) ? event : RV_HPM_NONE;
+
+    // preserve the counter value over the event change
+    hpmCounterW(riscv, index, value);
+
+    refreshHPMEvents(riscv);
+}
+
+//
+// Freeze or resume performance monitor counters on an mcountinhibit update
+//
+static void hpmInhibit(riscvP riscv, Uns32 oldValue, Uns32 newValue) {
+
+    Uns32 changed = (oldValue^newValue) & WM32_counteren_HPM;
+    Uns32 i;
+
+    for(i=3; i<32; i++) {
+
+        if(!(changed & (1<<i))) {
+            // no change
+        } else if(newValue & (1<<i)) {
+            riscv->hpmValue[i] = hpmCounterR(riscv, i);
+        } else {
+            riscv->hpmBase[i] = (
+                riscv->hpmCount[riscv->hpmEvent[i]] - riscv->hpmValue[i]
+            );
+        }
+    }
+}
+
 //
 // Get state before possible inhibit update
 //
@@ -1527,6 +1632,9 @@ static RISCV_CSR_WRITEFN(mcountinhibitW) {
     // get state before possible inhibit update
     riscvPreInhibit(riscv, &state);
 
+    // freeze or resume performance monitor counters
+    hpmInhibit(riscv, RD_CSR(riscv, mcountinhibit), newValue);
+
     // update the CSR
     WR_CSR(riscv, mcountinhibit, newValue);
 
@@ -1537,27 +1645,53 @@ static RISCV_CSR_WRITEFN(mcountinhibitW) {
 }
 
 //
-// Read unimplemented performance monitor register
+// Read performance monitor register
 //
 static RISCV_CSR_READFN(mhpmR) {
 
-    if(hpmAccessValid(attrs, riscv)) {
+    Uns32 num    = getCSRNum(attrs);
+    Uns32 index  = num & 31;
+    Uns64 result = 0;
+
+    if(!hpmAccessValid(attrs, riscv)) {
         // no action
+    } else if(HPM_IS_EVENT(num)) {
+        result = riscv->hpmEvent[index];
+    } else if(HPM_IS_HIGH(num)) {
+        result = hpmCounterR(riscv, index) >> 32;
+    } else {
+        result = getXLENValue(riscv, hpmCounterR(riscv, index));
     }
 
-    return 0;
+    return result;
 }
 
 //
-// Write unimplemented performance monitor register
+// Write performance monitor register
 //
 static RISCV_CSR_WRITEFN(mhpmW) {
 
-    if(hpmAccessValid(attrs, riscv)) {
+    Uns32 num   = getCSRNum(attrs);
+    Uns32 index = num & 31;
+
+    if(!hpmAccessValid(attrs, riscv)) {
         // no action
+    } else if(HPM_IS_EVENT(num)) {
+        hpmEventW(riscv, index, newValue);
+    } else {
+
+        Uns64 oldValue = hpmCounterR(riscv, index);
+
+        if(HPM_IS_HIGH(num)) {
+            hpmCounterW(riscv, index, setUpper(newValue, oldValue));
+        } else if(RISCV_XLEN_IS_32(riscv)) {
+            hpmCounterW(riscv, index, setLower(newValue, oldValue));
+        } else {
+            hpmCounterW(riscv, index, newValue);
+        }
     }
 
-    return 0;
+    return newValue;
 }
 
 
@@ -1695,6 +1829,9 @@ static RISCV_CSR_WRITEFN(vxrmW) {
     // update fixed point rounding mode alias
     WR_CSR_FIELD(riscv, vxrm, rm, newValue);
 
+    // set matching polymorphic key
+    riscvRefreshVectorPMKey(riscv);
+
     return newValue;
 }
 
@@ -1753,6 +1890,9 @@ static RISCV_CSR_WRITEFN(vcsrW) {
     // update fixed point rounding mode alias
     WR_CSR_FIELD(riscv, vxrm, rm, RD_CSR_FIELD(riscv, vcsr, vxrm));
 
+    // set matching polymorphic key
+    riscvRefreshVectorPMKey(riscv);
+
     // return written value
     return RD_CSR(riscv, vcsr);
 }
@@ -1765,6 +1905,7 @@ void riscvRefreshVectorPMKey(riscvP riscv) {
     Uns32 vl       = RD_CSR(riscv, vl);
     Uns32 vtypeKey = RD_CSR(riscv, vtype)<<2;
     Uns32 villKey  = RD_CSR_FIELD(riscv, vtype, vill)<<2;
+    Uns32 vxrmKey  = RD_CSR_FIELD(riscv, vxrm, rm)<<PMK_VXRM_SHIFT;
     Uns32 pmKey;
 
     // compose key
@@ -1778,8 +1919,11 @@ void riscvRefreshVectorPMKey(riscvP riscv) {
         pmKey = VLCLASSMT_NONZERO | vtypeKey;
     }
 
+    // include fixed point rounding mode (allows rounding to be inlined)
+    pmKey |= vxrmKey;
+
     // update polymorphic key
-    riscv->pmKey = (riscv->pmKey & ~PMK_VECTOR) | pmKey;
+    riscv->pmKey = (riscv->pmKey & ~(PMK_VECTOR|PMK_VXRM)) | pmKey;
 }
 
 //
@@ -2094,7 +2238,7 @@ static const riscvCSRAttrs csrs[CSR_ID(LAST)] = {
     CSR_ATTR_TV_     (utvt,         0x007, ISA_N,       0,          1_10,   0,0,0,  "User CLIC Trap-Vector Base-Address",            clicP,  0,           0,          0,     0             ),
     CSR_ATTR_TV_     (vstart,       0x008, ISA_V,       0,          1_10,   0,0,0,  "Vector Start Index",                            0,      riscvWVStart,0,          0,     0             ),
     CSR_ATTR_TC_     (vxsat,        0x009, ISA_V,       ISA_FSandV, 1_10,   0,0,0,  "Fixed-Point Saturate Flag",                     0,      riscvWFSVS,  vxsatR,     0,     vxsatW        ),
-    CSR_ATTR_TC_     (vxrm,         0x00A, ISA_V,       ISA_FSandV, 1_10,   0,0,0,  "Fixed-Point Rounding Mode",                     0,      riscvWFSVS,  0,          0,     vxrmW         ),
+    CSR_ATTR_TC_     (vxrm,         0x00A, ISA_V,       ISA_FSandV, 1_10,   1,0,0,  "Fixed-Point Rounding Mode",                     0,      riscvWFSVS,  0,          0,     vxrmW         ),
     CSR_ATTR_T__     (vcsr,         0x00F, ISA_V,       0,          1_10,   1,0,0,  "Vector Control and Status",                     vcsrP,  riscvWVCSR,  vcsrR,      0,     vcsrW         ),
     CSR_ATTR_T__     (uscratch,     0x040, ISA_N,       0,          1_10,   0,0,0,  "User Scratch",                                  0,      0,           0,          0,     0             ),
     CSR_ATTR_TV_     (uepc,         0x041, ISA_N,       0,          1_10,   0,0,0,  "User Exception Program Counter",                0,      0,           uepcR,      0,     0             ),
@@ -2749,6 +2893,7 @@ void riscvCSRReset(riscvP riscv) {
 
     riscvConfigP      cfg  = &riscv->configInfo;
     riscvArchitecture arch = cfg->arch;
+    Uns32             i;
 
     // switch all register state to the widest supported state
     toConfiguredArch(0, riscv);
@@ -2777,6 +2922,15 @@ void riscvCSRReset(riscvP riscv) {
 
     // clear exclusive tag
     riscv->exclusiveTag = RISCV_NO_TAG;
+
+    // refresh interrupt delegation masks
+    riscvRefreshInterruptDelegation(riscv);
+
+    // deselect all performance monitor events
+    for(i=0; i<32; i++) {
+        riscv->hpmEvent[i] = RV_HPM_NONE;
+    }
+    refreshHPMEvents(riscv);
 }
 
 //
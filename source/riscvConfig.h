@@ -77,6 +77,10 @@ typedef struct riscvConfigS {
     Uns64             no_ideleg;        // non-delegated interrupts
     Uns64             no_edeleg;        // non-delegated exceptions
     Uns32             local_int_num;    // number of local interrupts
+    Uns32             exception_trace;  // exception trace ring buffer entries
+    Uns32             profile_interval; // profiler sample interval
+    const char       *profile_file;     // profiler output file
+    const char       *binary_trace;     // binary trace output file
     Uns32             lr_sc_grain;      // LR/SC region grain size
     Uns32             ASID_bits;        // number of implemented ASID bits
     Uns32             PMP_grain;        // PMP region grain size
@@ -99,6 +103,7 @@ typedef struct riscvConfigS {
     Bool              unaligned;        // whether unaligned accesses supported
     Bool              unalignedAMO;     // whether AMO supports unaligned
     Bool              wfi_is_nop;       // whether WFI is treated as NOP
+    Bool              spin_yield;       // whether spin-wait loops yield
     Bool              mtvec_is_ro;      // whether mtvec is read-only
     Bool              cycle_undefined;  // whether cycle CSR is undefined
     Bool              time_undefined;   // whether time CSR is undefined
@@ -108,6 +113,11 @@ typedef struct riscvConfigS {
     Bool              require_vstart0;  // require vstart 0 if uninterruptible?
     Bool              enable_CSR_bus;   // enable CSR implementation bus
     Bool              external_int_id;  // enable external interrupt ID ports
+    Bool              batch_interrupts; // batch interrupt net changes
+    Bool              trap_stats;       // record trap statistics
+    Bool              profile_unwind;   // profiler unwinds frame pointers
+    Bool              jit_stats;        // record JIT statistics
+    Bool              tlb_stats;        // report TLB statistics
     Bool              tval_ii_code;     // instruction bits in [sm]tval for
                                         // illegal instruction exception?
 
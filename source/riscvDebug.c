@@ -281,13 +281,40 @@ static vmiRegUsage getGPRUsage(Uns32 i) {
     }
 }
 
+//
+// Can the register list of the passed hart be shared with the prototype? This
+// requires that all registers are at the same offset in the processor
+// structure in both harts: vector registers are allocated separately for each
+// hart, and extensions may add CSRs or ISRs in extension-specific state, so
+// lists are not shared in either case.
+//
+static Bool shareRegisters(riscvP riscv, riscvP prototype) {
+    return (
+        prototype &&
+        !riscv->extCBs && !prototype->extCBs &&
+        !(riscv->configInfo.arch & ISA_V) &&
+        (riscv->configInfo.arch==prototype->configInfo.arch)
+    );
+}
+
 //
 // Return register list (either normal or debug)
 //
 static vmiRegInfoCP getRegisters(riscvP riscv, Bool normal) {
 
-    // create registers if they have not been created
-    if(!riscv->regInfo[normal]) {
+    riscvP prototype = riscvGetSMPPrototype(riscv);
+
+    if(riscv->regInfo[normal]) {
+
+        // registers already created
+
+    } else if(shareRegisters(riscv, prototype)) {
+
+        // share list with SMP peer with identical configuration
+        riscv->regInfo[normal] = (vmiRegInfoP)getRegisters(prototype, normal);
+        riscv->sharedRegInfo   = True;
+
+    } else {
 
         Uns32             XLEN   = riscvGetXlenArch(riscv);
         Uns32             FLEN   = riscvGetFlenArch(riscv) ? : XLEN;
@@ -532,10 +559,10 @@ void riscvFreeRegInfo(riscvP riscv) {
     Uns32 i;
 
     for(i=0; i<2; i++) {
-        if(riscv->regInfo[i]) {
+        if(riscv->regInfo[i] && !riscv->sharedRegInfo) {
             STYPE_FREE(riscv->regInfo[i]);
-            riscv->regInfo[i] = 0;
         }
+        riscv->regInfo[i] = 0;
     }
 }
 
@@ -593,6 +620,7 @@ VMI_REG_IMPL_FN(riscvRegImpl) {
 
     // exclude artifact registers
     RISCV_FIELD_IMPL_IGNORE(pmKey);
+    RISCV_FIELD_IMPL_IGNORE(hpmCount);
     RISCV_FIELD_IMPL_IGNORE(vFirstFault);
     RISCV_FIELD_IMPL_IGNORE(vBase);
     RISCV_FIELD_IMPL_IGNORE(offsetsLMULx2);
@@ -412,10 +412,100 @@ void riscvDoc(riscvP rootProcessor) {
                 "instead be configured as a NOP using parameter \"wfi_is_nop\". "
                 "WFI timeout wait is implemented with a time limit of 0 (i.e. "
                 "WFI causes an Illegal Instruction trap in Supervisor mode "
-                "when mstatus.TW=1)."
+                "when mstatus.TW=1). A halted hart consumes no simulation "
+                "time until an interrupt becomes pending and enabled. A "
+                "derived model that knows the time of the next wake-up event "
+                "(for example, a timer compare) may register it using the "
+                "setWFIWakeup callback, allowing the simulator to advance "
+                "directly to that time."
             );
         }
 
+        // document spin-wait loop behavior
+        vmidocAddText(
+            Features,
+            "Set parameter \"spin_yield\" to \"T\" to make spin-wait loops "
+            "yield the remainder of the current quantum. A spin-wait loop is "
+            "a conditional branch back to the start of a translated block "
+            "that reads memory but does not write it, in which all loads use "
+            "the same base register, and which is taken with that base "
+            "register unchanged since the previous iteration. Loops that "
+            "read the same address while counting in registers (for example, "
+            "delay loops polling a device register) are also classified as "
+            "spin-wait loops, which changes how harts are scheduled."
+        );
+
+        // document trap statistics
+        vmidocAddText(
+            Features,
+            "Set parameter \"trap_stats\" to \"T\" to record, for each "
+            "destination mode, trap counts by cause, interrupt latency (cycles "
+            "from an interrupt becoming pending to trap entry) and handler "
+            "residency (cycles from trap entry to xRET). Statistics are "
+            "reported by command \"trapStats\" and at the end of simulation."
+        );
+
+        // document exception trace
+        vmidocAddText(
+            Features,
+            "Set parameter \"exception_trace\" to a non-zero value to record "
+            "that number of most recent traps (cause, tval, EPC, handler "
+            "address, source and destination mode and cycle count) in a ring "
+            "buffer. The buffer is shown by command \"exceptionTrace\" and is "
+            "also shown automatically the first time a trap loop (a "
+            "synchronous exception at the handler address of an identical "
+            "previous exception) is detected."
+        );
+
+        // document sampling profiler
+        vmidocAddText(
+            Features,
+            "Set parameter \"profile_interval\" to a non-zero value N to "
+            "sample the guest program counter once every N instructions. "
+            "If parameter \"profile_unwind\" is \"T\", the guest frame "
+            "pointer chain is also unwound at each sample so that "
+            "complete call stacks are recorded (this requires guest code "
+            "compiled with frame pointers). At the end of simulation, sample "
+            "counts are written in folded-stack format, suitable for flame "
+            "graph tools, to the file named by parameter \"profile_file\" "
+            "with the hart name appended, or to the simulator log if that "
+            "parameter is empty."
+        );
+
+        // document JIT statistics
+        vmidocAddText(
+            Features,
+            "Set parameter \"jit_stats\" to \"T\" to record the number of "
+            "code blocks and instructions translated, the host time spent "
+            "translating and the number of times code at the same address is "
+            "translated again, classified by cause (polymorphic key, mode or "
+            "XLEN change, model flush, or code modification). Statistics, "
+            "including the most frequently retranslated addresses, are "
+            "reported by command \"jitStats\" and at the end of simulation."
+        );
+
+        // document TLB statistics
+        vmidocAddText(
+            Features,
+            "Set parameter \"tlb_stats\" to \"T\" to report the number of "
+            "TLB misses and page table walk reads (artifact accesses are not "
+            "counted) by command \"tlbStats\" and at the end of simulation."
+        );
+
+        // document binary trace
+        vmidocAddText(
+            Features,
+            "Set parameter \"binary_trace\" to a file name prefix to write a "
+            "compact binary trace of executed instructions to a file with the "
+            "hart name appended. Each record holds the instruction word, the "
+            "address (as a delta from the previous sequential address, only "
+            "when control flow is not sequential), the new values of any X "
+            "registers changed by the instruction and the address of its first "
+            "memory access. Instructions that take a synchronous exception "
+            "are flagged as not completed. The format is described in file "
+            "riscvBinaryTrace.h."
+        );
+
         // document whether cycle CSR is implemented
         if(cfg->cycle_undefined) {
             vmidocAddText(
@@ -1120,6 +1210,16 @@ void riscvDoc(riscvP rootProcessor) {
             "to zero."
         );
 
+        vmidocAddText(
+            Ports,
+            "The same reset may be applied without driving the \"reset\" "
+            "port using the \"resetHart\" command. All TLB entries are "
+            "discarded on reset but model configuration and translated code "
+            "are retained, so a regression harness may load successive "
+            "programs and reset each hart with this command instead of "
+            "constructing a new simulator for every program."
+        );
+
         vmidocAddText(
             Ports,
             "The \"nmi\" port is an active-high NMI input. The processor "
@@ -1528,8 +1628,19 @@ void riscvDoc(riscvP rootProcessor) {
 
         vmidocAddText(
             Limitations,
-            "Hardware Performance Monitor and Debug registers are not "
-            "implemented and hardwired to zero."
+            "Debug registers are not implemented and hardwired to zero."
+        );
+
+        vmidocAddText(
+            Limitations,
+            "Hardware Performance Monitor counters count the event selected "
+            "by the corresponding mhpmevent register: 1 (loads), 2 (stores), "
+            "3 (taken branches and jumps), 4 (AMOs), 5 (floating point "
+            "instructions), 6 (vector instructions), 7 (CSR accesses), 8 (TLB "
+            "misses), 9 (page table walk reads) or 10 (traps). Other values "
+            "select no event. Instruction events are counted when an "
+            "instruction is issued, including instructions that subsequently "
+            "trap."
         );
 
         if(cfg->arch&ISA_S) {
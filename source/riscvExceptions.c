@@ -29,6 +29,8 @@
 #include "vmi/vmiRt.h"
 
 // model header files
+#include "riscvBinaryTrace.h"
+#include "riscvBlockState.h"
 #include "riscvCSR.h"
 #include "riscvDecode.h"
 #include "riscvExceptions.h"
@@ -36,6 +38,8 @@
 #include "riscvFunctions.h"
 #include "riscvMessage.h"
 #include "riscvStructure.h"
+#include "riscvTrapStats.h"
+#include "riscvTrapTrace.h"
 #include "riscvUtils.h"
 #include "riscvVM.h"
 #include "riscvVMConstants.h"
@@ -348,13 +352,19 @@ static Bool accessFaultCode(riscvException exception) {
 // Notify a derived model of trap entry or exception return if required
 //
 inline static void notifyTrapDerived(
-    riscvP              riscv,
-    riscvMode           mode,
-    riscvTrapNotifierFn notifier,
-    void               *clientData
+    riscvP          riscv,
+    riscvMode       mode,
+    riscvExtCBEvent event
 ) {
-    if(notifier) {
-        notifier(riscv, mode, clientData);
+    riscvExtCBP extCB;
+
+    RISCV_FOR_EACH_EXT_CB(riscv, event, extCB) {
+
+        riscvTrapNotifierFn notifier = (event==RVECB_TRAP) ?
+            extCB->trapNotifier :
+            extCB->ERETNotifier;
+
+        notifier(riscv, mode, extCB->clientData);
     }
 }
 
@@ -362,13 +372,7 @@ inline static void notifyTrapDerived(
 // Notify a derived model of exception return if required
 //
 inline static void notifyERETDerived(riscvP riscv, riscvMode mode) {
-
-    riscvExtCBP extCB;
-
-    // call derived model preMorph functions if required
-    for(extCB=riscv->extCBs; extCB; extCB=extCB->next) {
-        notifyTrapDerived(riscv, mode, extCB->ERETNotifier, extCB->clientData);
-    }
+    notifyTrapDerived(riscv, mode, RVECB_ERET);
 }
 
 //
@@ -404,7 +408,6 @@ void riscvTakeException(
         Uns64       handlerPC = 0;
         riscvMode   modeY     = getCurrentMode(riscv);
         riscvMode   modeX;
-        riscvExtCBP extCB;
         Uns64       base;
         riscvICMode mode;
 
@@ -415,6 +418,11 @@ void riscvTakeException(
             riscv->baseInstructions++;
         }
 
+        // mark binary trace record of an instruction that does not complete
+        if(riscv->binaryTrace && !isInt && !retiredCode(exception)) {
+            riscvBinaryTraceException(riscv, EPC);
+        }
+
         // latch or clear Access Fault detail depending on exception type
         if(accessFaultCode(exception)) {
             riscv->AFErrorOut = riscv->AFErrorIn;
@@ -464,6 +472,21 @@ void riscvTakeException(
             handlerPC = base + (4 * ecode);
         }
 
+        // count trap event
+        riscv->hpmCount[RV_HPM_TRAP]++;
+
+        // record trap statistics if required
+        if(riscv->trapStats) {
+            riscvTrapStatsTrap(riscv, exception, modeX);
+        }
+
+        // record trap in exception trace if required
+        if(riscv->trapTrace) {
+            riscvTrapTraceAdd(
+                riscv, exception, tval, EPC, handlerPC, modeY, modeX
+            );
+        }
+
         // switch to target mode
         riscvSetMode(riscv, modeX);
 
@@ -474,16 +497,14 @@ void riscvTakeException(
         vmirtSetPCException((vmiProcessorP)riscv, handlerPC);
 
         // notify derived model of exception entry if required
-        for(extCB=riscv->extCBs; extCB; extCB=extCB->next) {
-            notifyTrapDerived(riscv, modeX, extCB->trapNotifier, extCB->clientData);
-        }
+        notifyTrapDerived(riscv, modeX, RVECB_TRAP);
     }
 }
 
 //
 // Return description of the given exception
 //
-static const char *getExceptionDesc(riscvException exception, char *buffer) {
+const char *riscvGetExceptionDesc(riscvException exception, char *buffer) {
 
     const char *result = 0;
 
@@ -521,7 +542,7 @@ static void reportMemoryException(
         vmiMessage("W", CPU_PREFIX "_IMA",
             SRCREF_FMT "%s (0x"FMT_Ax")",
             SRCREF_ARGS(riscv, getPC(riscv)),
-            getExceptionDesc(exception, buffer), tval
+            riscvGetExceptionDesc(exception, buffer), tval
         );
     }
 }
@@ -618,6 +639,11 @@ static void doERETCommon(
     riscvMode newMode,
     Uns64     epc
 ) {
+    // record handler residency if required
+    if(riscv->trapStats) {
+        riscvTrapStatsReturn(riscv, retMode);
+    }
+
     // switch to target mode
     riscvSetMode(riscv, newMode);
 
@@ -751,6 +777,12 @@ inline static void setDM(riscvP riscv, Bool DM) {
 
     riscv->DM = DM;
 
+    // all interrupts are disabled in Debug mode
+    riscvRefreshPendingAndEnabled(riscv);
+
+    // single-step is inactive in Debug mode
+    riscvSetStepBreakpoint(riscv);
+
     // indicate new Debug mode
     vmirtWriteNetPort((vmiProcessorP)riscv, riscv->DMPortHandle, DM);
 }
@@ -847,24 +879,46 @@ void riscvSetDMStall(riscvP riscv, Bool DMStall) {
 }
 
 //
-// Instruction step breakpoint callback
+// Is single-step active?
 //
-static VMI_ICOUNT_FN(riscvStepExcept) {
+inline static Bool stepActive(riscvP riscv) {
+    return !inDebugMode(riscv) && RD_CSR_FIELD(riscv, dcsr, step);
+}
 
-    riscvP riscv = (riscvP)processor;
+//
+// Set step breakpoint if required. Single-step is implemented using a
+// polymorphic key: when set, each translated block holds one instruction
+// preceded by a call to riscvStepInstruction, so no timer need be armed for
+// each step.
+//
+void riscvSetStepBreakpoint(riscvP riscv) {
+
+    if(!stepActive(riscv)) {
+
+        riscv->pmKey &= ~PMK_STEP;
+
+    } else {
 
-    if(!inDebugMode(riscv) && RD_CSR_FIELD(riscv, dcsr, step)) {
-        enterDM(riscv, DMC_STEP);
+        // flush dictionaries the first time single-step is enabled, so that
+        // all blocks validate the polymorphic key
+        if(!riscv->useStepKey) {
+            riscv->useStepKey = True;
+            riscvFlushAllDicts(riscv);
+        }
+
+        riscv->pmKey |= PMK_STEP;
     }
 }
 
 //
-// Set step breakpoint if required
+// Called before a single-stepped instruction executes: Debug mode is entered
+// at the next instruction fetch (the next instruction or any trap handler)
 //
-void riscvSetStepBreakpoint(riscvP riscv) {
+void riscvStepInstruction(riscvP riscv) {
 
-    if(!inDebugMode(riscv) && RD_CSR_FIELD(riscv, dcsr, step)) {
-        vmirtSetModelTimer(riscv->stepTimer, 1);
+    if(stepActive(riscv)) {
+        riscv->stepPending = True;
+        vmirtDoSynchronousInterrupt((vmiProcessorP)riscv);
     }
 }
 
@@ -1120,7 +1174,7 @@ inline static Uns64 getPendingInterrupts(riscvP riscv) {
 }
 
 //
-// Return mask of pending-and-enabled interrupts
+// Calculate mask of pending-and-enabled interrupts
 //
 static Uns64 getPendingAndEnabledInterrupts(riscvP riscv) {
 
@@ -1157,37 +1211,101 @@ static Uns64 getPendingAndEnabledInterrupts(riscvP riscv) {
 }
 
 //
-// Get priority for the indexed interrupt
+// Refresh cached pending-and-enabled interrupt state (this must be called
+// whenever mip, mie, mstatus.[MSU]IE, mideleg, sideleg, the current mode or
+// Debug mode state change)
 //
-static Uns32 getIntPri(Uns32 intNum) {
+void riscvRefreshPendingAndEnabled(riscvP riscv) {
+    riscv->pendEnab = getPendingAndEnabledInterrupts(riscv);
+}
 
-    #define INT_INDEX(_NAME) (riscv_E_##_NAME-riscv_E_Interrupt)
+//
+// Return interrupt number of the named standard interrupt
+//
+#define INT_INDEX(_NAME) (riscv_E_##_NAME-riscv_E_Interrupt)
 
-    // static table of priority mappings (NOTE: local and custom interrupts are
-    // assumed to be lowest priority, indicated by default value 0 in this
-    // table and value returned when out of range below)
-    static const Uns8 intPri[INT_INDEX(Last)] = {
-        [INT_INDEX(UTimerInterrupt)]    = 1,
-        [INT_INDEX(USWInterrupt)]       = 2,
-        [INT_INDEX(UExternalInterrupt)] = 3,
-        [INT_INDEX(STimerInterrupt)]    = 4,
-        [INT_INDEX(SSWInterrupt)]       = 5,
-        [INT_INDEX(SExternalInterrupt)] = 6,
-        [INT_INDEX(MTimerInterrupt)]    = 7,
-        [INT_INDEX(MSWInterrupt)]       = 8,
-        [INT_INDEX(MExternalInterrupt)] = 9,
-    };
+//
+// Standard interrupts in increasing fixed priority order (local and custom
+// interrupts have lower priority than all of these)
+//
+static const Uns8 intByPri[] = {
+    INT_INDEX(UTimerInterrupt),
+    INT_INDEX(USWInterrupt),
+    INT_INDEX(UExternalInterrupt),
+    INT_INDEX(STimerInterrupt),
+    INT_INDEX(SSWInterrupt),
+    INT_INDEX(SExternalInterrupt),
+    INT_INDEX(MTimerInterrupt),
+    INT_INDEX(MSWInterrupt),
+    INT_INDEX(MExternalInterrupt),
+};
 
-    return (intNum>=INT_INDEX(Last)) ? 0 : intPri[intNum];
+//
+// Tables permuting bits 0-7 and 8-15 of an interrupt mask so that bit N of
+// the result is set if the standard interrupt with fixed priority N+1 is in
+// the mask
+//
+static Uns16 intPriLo[256];
+static Uns16 intPriHi[256];
+
+//
+// Fill interrupt priority permutation tables on first use
+//
+static void initIntPriTables(void) {
+
+    static Bool init;
+
+    if(!init) {
+
+        Uns32 i, j;
+
+        for(i=0; i<sizeof(intByPri); i++) {
+
+            Uns32 ecode = intByPri[i];
+
+            for(j=0; j<256; j++) {
+                if((j<<0) & (1<<ecode)) {intPriLo[j] |= 1<<i;}
+                if((j<<8) & (1<<ecode)) {intPriHi[j] |= 1<<i;}
+            }
+        }
+
+        init = True;
+    }
 }
 
 //
-// Descriptor for pending-and-enabled interrupt
+// Return the highest-priority interrupt in the given non-zero mask of
+// interrupts that are all taken to the same mode
 //
-typedef struct intDescS {
-    Uns32     ecode;    // exception code
-    riscvMode emode;    // mode to which taken
-} intDesc;
+static Uns32 selectInterrupt(Uns64 intMask) {
+
+    Uns32 stdMask = intPriLo[intMask&0xff] | intPriHi[(intMask>>8)&0xff];
+
+    if(stdMask) {
+        // highest fixed-priority standard interrupt
+        return intByPri[31-__builtin_clz(stdMask)];
+    } else {
+        // local and custom interrupts are ordered by interrupt number
+        return 63-__builtin_clzll(intMask);
+    }
+}
+
+//
+// Refresh masks of interrupts delegated to each mode (called when mideleg or
+// sideleg change)
+//
+void riscvRefreshInterruptDelegation(riscvP riscv) {
+
+    Uns64 mideleg = (Uns32)RD_CSR(riscv, mideleg);
+    Uns64 sideleg = (Uns32)RD_CSR(riscv, sideleg) & mideleg;
+
+    riscv->intModeMask[RISCV_MODE_MACHINE]    = ~mideleg;
+    riscv->intModeMask[RISCV_MODE_HYPERVISOR] = 0;
+    riscv->intModeMask[RISCV_MODE_SUPERVISOR] = mideleg & ~sideleg;
+    riscv->intModeMask[RISCV_MODE_USER]       = sideleg;
+
+    initIntPriTables();
+}
 
 //
 // Process highest-priority interrupt in the given mask of pending-and-enabled
@@ -1195,41 +1313,28 @@ typedef struct intDescS {
 //
 static void doInterrupt(riscvP riscv, Uns64 intMask) {
 
-    Uns32   ecode    = 0;
-    intDesc selected = {ecode:-1};
+    riscvMode modeY = getCurrentMode(riscv);
+    riscvMode modeX;
+    Uns64     modeMask;
 
     // sanity check there are pending-and-enabled interrupts
     VMI_ASSERT(intMask, "expected pending-and-enabled interrupts");
 
-    // find the highest priority pending-and-enabled interrupt
-    do {
-
-        if(intMask&1) {
-
-            intDesc try = {ecode:ecode, emode:getInterruptModeX(riscv, ecode)};
-
-            if(selected.ecode==-1) {
-                // first pending-and-enabled interrupt
-                selected = try;
-            } else if(selected.emode < try.emode) {
-                // higher destination privilege mode
-                selected = try;
-            } else if(selected.emode > try.emode) {
-                // lower destination privilege mode
-            } else if(getIntPri(selected.ecode)<=getIntPri(try.ecode)) {
-                // higher fixed priority order and same destination mode
-                selected = try;
-            }
+    // interrupts delegated to a mode above the current mode are taken to that
+    // mode in preference to all others
+    for(modeX=RISCV_MODE_MACHINE; modeX>modeY; modeX--) {
+        if((modeMask=intMask&riscv->intModeMask[modeX])) {
+            break;
         }
+    }
 
-        // step to next potential pending-and-enabled interrupt
-        intMask >>= 1;
-        ecode++;
-
-    } while(intMask);
+    // remaining interrupts are taken to the current mode
+    if(modeX==modeY) {
+        modeMask = intMask;
+    }
 
     // take the interrupt
-    riscvTakeException(riscv, riscv_E_Interrupt+selected.ecode, 0);
+    riscvTakeException(riscv, riscv_E_Interrupt+selectInterrupt(modeMask), 0);
 }
 
 //
@@ -1241,7 +1346,12 @@ VMI_IFETCH_FN(riscvIFetchExcept) {
     riscvP riscv   = (riscvP)processor;
     Uns64  thisPC  = address;
     Bool   fetchOK = False;
-    Uns64  intMask = getPendingAndEnabledInterrupts(riscv);
+    Uns64  intMask;
+
+    // apply any batched interrupt net changes
+    riscvFlushPending(riscv);
+
+    intMask = riscv->pendEnab;
 
     if(riscv->netValue.resethaltreqS) {
 
@@ -1258,6 +1368,18 @@ VMI_IFETCH_FN(riscvIFetchExcept) {
             enterDM(riscv, DMC_HALTREQ);
         }
 
+    } else if(riscv->stepPending) {
+
+        // enter Debug mode after single-step
+        if(complete) {
+            riscv->stepPending = False;
+            if(stepActive(riscv)) {
+                enterDM(riscv, DMC_STEP);
+            } else {
+                fetchOK = True;
+            }
+        }
+
     } else if(intMask) {
 
         // handle pending interrupt
@@ -1313,13 +1435,41 @@ static Uns32 getLocalIntNum(riscvP riscv) {
     return isContainer ? 0 : riscv->configInfo.local_int_num;
 }
 
+//
+// Can the exception list of the given SMP prototype be shared? (not if either
+// hart has extension exceptions, which are added by the extension of each hart)
+//
+static Bool shareExceptions(riscvP riscv, riscvP prototype) {
+    return (
+        prototype &&
+        !RISCV_HAS_EXT_CB(riscv, RVECB_EXCEPT) &&
+        !RISCV_HAS_EXT_CB(prototype, RVECB_EXCEPT) &&
+        (prototype->exceptionMask==riscv->exceptionMask) &&
+        (prototype->interruptMask==riscv->interruptMask) &&
+        (getLocalIntNum(prototype)==getLocalIntNum(riscv))
+    );
+}
+
 //
 // Return all defined exceptions, including those from intercepts, in a null
 // terminated list
 //
 static vmiExceptionInfoCP getExceptions(riscvP riscv) {
 
-    if(!riscv->exceptions) {
+    riscvP prototype = riscvGetSMPPrototype(riscv);
+
+    if(riscv->exceptions) {
+
+        // exceptions already known
+
+    } else if(shareExceptions(riscv, prototype)) {
+
+        // share list with SMP peer with identical configuration
+        riscv->exceptions   = getExceptions(prototype);
+        riscv->exceptionNum = prototype->exceptionNum;
+        riscv->sharedExcept = True;
+
+    } else {
 
         Uns32       numLocal = getLocalIntNum(riscv);
         Uns32       numExcept;
@@ -1334,14 +1484,12 @@ static vmiExceptionInfoCP getExceptions(riscvP riscv) {
         }
 
         // include exceptions for derived model
-        for(extCB=riscv->extCBs; extCB; extCB=extCB->next) {
-            if(extCB->firstException) {
-                vmiExceptionInfoCP list = extCB->firstException(
-                    riscv, extCB->clientData
-                );
-                while(list && list->name) {
-                    numExcept++; list++;
-                }
+        RISCV_FOR_EACH_EXT_CB(riscv, RVECB_EXCEPT, extCB) {
+            vmiExceptionInfoCP list = extCB->firstException(
+                riscv, extCB->clientData
+            );
+            while(list && list->name) {
+                numExcept++; list++;
             }
         }
 
@@ -1362,14 +1510,12 @@ static vmiExceptionInfoCP getExceptions(riscvP riscv) {
         }
 
         // fill exceptions from derived model
-        for(extCB=riscv->extCBs; extCB; extCB=extCB->next) {
-            if(extCB->firstException) {
-                vmiExceptionInfoCP list = extCB->firstException(
-                    riscv, extCB->clientData
-                );
-                while(list && list->name) {
-                    all[numExcept++] = *list++;
-                }
+        RISCV_FOR_EACH_EXT_CB(riscv, RVECB_EXCEPT, extCB) {
+            vmiExceptionInfoCP list = extCB->firstException(
+                riscv, extCB->clientData
+            );
+            while(list && list->name) {
+                all[numExcept++] = *list++;
             }
         }
 
@@ -1384,7 +1530,9 @@ static vmiExceptionInfoCP getExceptions(riscvP riscv) {
 
             this->code        = riscv_E_LocalInterrupt+i;
             this->name        = strdup(buffer);
-            this->description = strdup(getExceptionDesc(this->code, buffer));
+            this->description = strdup(
+                riscvGetExceptionDesc(this->code, buffer)
+            );
         }
 
         // save list on base model
@@ -1475,7 +1623,12 @@ void riscvSetExceptionMask(riscvP riscv) {
 //
 void riscvExceptFree(riscvP riscv) {
 
-    if(riscv->exceptions) {
+    if(riscv->sharedExcept) {
+
+        // list is owned by SMP peer
+        riscv->exceptions = 0;
+
+    } else if(riscv->exceptions) {
 
         Uns32              numLocal    = getLocalIntNum(riscv);
         Uns32              numNotLocal = riscv->exceptionNum - numLocal;
@@ -1518,17 +1671,68 @@ inline static Bool negedge(Uns32 old, Uns32 new) {
 //
 void riscvWFI(riscvP riscv) {
 
+    // apply any batched interrupt net changes
+    riscvFlushPending(riscv);
+
     if(!(inDebugMode(riscv) || getPendingInterrupts(riscv))) {
         haltProcessor(riscv, RVD_WFI);
     }
 }
 
+//
+// WFI wake-up timer callback
+//
+static VMI_ICOUNT_FN(riscvWakeExcept) {
+
+    riscvP riscv = (riscvP)processor;
+
+    // WFI may complete at any time, so resumption without an interrupt is
+    // legal
+    restartProcessor(riscv, RVD_RESTART_WFI);
+}
+
+//
+// Allocate the WFI wake-up timer on first use
+//
+static void newWakeTimer(riscvP riscv) {
+
+    if(!riscv->wakeTimer) {
+        riscv->wakeTimer = vmirtCreateModelTimer(
+            (vmiProcessorP)riscv, riscvWakeExcept, 1, 0
+        );
+    }
+}
+
+//
+// Specify the number of cycles after which a hart halted in WFI should resume.
+// This is intended for platform-aware derived models that know the time of
+// the next timer compare event: the wake-up timer is then the only pending
+// event for an idle hart, allowing the simulator to advance directly to it
+// instead of stepping through idle quanta. Zero cancels any pending wake-up.
+// The timer is created by the first request, so harts that never use this
+// have no timer to schedule, save or restore.
+//
+void riscvSetWFIWakeup(riscvP riscv, Uns64 cycles) {
+
+    if(cycles) {
+        newWakeTimer(riscv);
+        vmirtSetModelTimer(riscv->wakeTimer, cycles);
+    } else if(riscv->wakeTimer) {
+        vmirtClearModelTimer(riscv->wakeTimer);
+    }
+}
+
 //
 // Check for pending interrupts
 //
 void riscvTestInterrupt(riscvP riscv) {
 
-    Uns64 pendingEnabled = getPendingAndEnabledInterrupts(riscv);
+    Uns64 pendingEnabled;
+
+    // refresh cached pending-and-enabled state
+    riscvRefreshPendingAndEnabled(riscv);
+
+    pendingEnabled = riscv->pendEnab;
 
     // print exception status
     if(RISCV_DEBUG_EXCEPT(riscv)) {
@@ -1574,6 +1778,12 @@ void riscvTestInterrupt(riscvP riscv) {
     // restart processor if it is halted in WFI state and local interrupts are
     // pending (even if masked)
     if(getPendingInterrupts(riscv)) {
+
+        // an interrupt ends the WFI, so any registered wake-up is redundant
+        if(riscv->disable & RVD_WFI) {
+            riscvSetWFIWakeup(riscv, 0);
+        }
+
         restartProcessor(riscv, RVD_RESTART_WFI);
     }
 
@@ -1591,6 +1801,9 @@ void riscvReset(riscvP riscv) {
 
     riscvExtCBP extCB;
 
+    // cancel any WFI wake-up registered before reset
+    riscvSetWFIWakeup(riscv, 0);
+
     // restart the processor from any halted state
     restartProcessor(riscv, RVD_RESTART_RESET);
 
@@ -1603,11 +1816,12 @@ void riscvReset(riscvP riscv) {
     // reset CSR state
     riscvCSRReset(riscv);
 
+    // discard all TLB entries so that no translation survives reset
+    riscvVMInvalidateAll(riscv);
+
     // notify dependent model of reset event
-    for(extCB=riscv->extCBs; extCB; extCB=extCB->next) {
-        if(extCB->resetNotifier) {
-            extCB->resetNotifier(riscv, extCB->clientData);
-        }
+    RISCV_FOR_EACH_EXT_CB(riscv, RVECB_RESET, extCB) {
+        extCB->resetNotifier(riscv, extCB->clientData);
     }
 
     // indicate the taken exception
@@ -1618,6 +1832,9 @@ void riscvReset(riscvP riscv) {
 
     // enter Debug mode out of reset if required
     riscv->netValue.resethaltreqS = riscv->netValue.resethaltreq;
+
+    // refresh pending-and-enabled state using reset CSR values
+    riscvRefreshPendingAndEnabled(riscv);
 }
 
 //
@@ -1662,11 +1879,28 @@ void riscvUpdatePending(riscvP riscv) {
 
     // update register value and exception state on a change
     if(oldValue != newValue) {
+
+        // record interrupt pending times if required
+        if(riscv->trapStats) {
+            riscvTrapStatsPending(riscv, oldValue, newValue);
+        }
+
         WR_CSR(riscv, mip, newValue);
         riscvTestInterrupt(riscv);
     }
 }
 
+//
+// Apply any interrupt net changes deferred by batching
+//
+void riscvFlushPending(riscvP riscv) {
+
+    if(riscv->ipDirty) {
+        riscv->ipDirty = False;
+        riscvUpdatePending(riscv);
+    }
+}
+
 //
 // Reset signal
 //
@@ -1763,7 +1997,19 @@ static VMI_NET_CHANGE_FN(interruptPortCB) {
         riscv->ip[offset] &= ~mask;
     }
 
-    riscvUpdatePending(riscv);
+    if(!riscv->configInfo.batch_interrupts || riscv->disable) {
+
+        // update pending state immediately (always required for a halted
+        // processor, which will not fetch again until restarted)
+        riscvUpdatePending(riscv);
+
+    } else if(!riscv->ipDirty) {
+
+        // defer update of pending state until the next instruction fetch, so
+        // that many net changes in one time instant cause only one update
+        riscv->ipDirty = True;
+        vmirtDoSynchronousInterrupt((vmiProcessorP)riscv);
+    }
 }
 
 //
@@ -2039,25 +2285,13 @@ VMI_NET_PORT_SPECS_FN(riscvNetPortSpecs) {
 // TIMER CREATION
 ////////////////////////////////////////////////////////////////////////////////
 
-//
-// Allocate timers
-//
-void riscvNewTimers(riscvP riscv) {
-
-    if(riscv->configInfo.debug_mode) {
-        riscv->stepTimer = vmirtCreateModelTimer(
-            (vmiProcessorP)riscv, riscvStepExcept, 1, 0
-        );
-    }
-}
-
 //
 // Free timers
 //
 void riscvFreeTimers(riscvP riscv) {
 
-    if(riscv->stepTimer) {
-        vmirtDeleteModelTimer(riscv->stepTimer);
+    if(riscv->wakeTimer) {
+        vmirtDeleteModelTimer(riscv->wakeTimer);
     }
 }
 
@@ -2117,9 +2351,17 @@ void riscvTimerSave(
 ) {
     if(phase==SRT_END_CORE) {
 
-        if(riscv->stepTimer) {
-            vmirtSaveModelTimer(cxt, "stepTimer", riscv->stepTimer);
+        Bool wakeTimer = riscv->wakeTimer ? True : False;
+
+        // save WFI wake-up timer if it has been allocated
+        vmirtSave(cxt, "wakeTimerValid", &wakeTimer, sizeof(wakeTimer));
+
+        if(wakeTimer) {
+            vmirtSaveModelTimer(cxt, "wakeTimer", riscv->wakeTimer);
         }
+
+        // save single-step state
+        VMIRT_SAVE_FIELD(cxt, riscv, stepPending);
     }
 }
 
@@ -2133,9 +2375,21 @@ void riscvTimerRestore(
 ) {
     if(phase==SRT_END_CORE) {
 
-        if(riscv->stepTimer) {
-            vmirtRestoreModelTimer(cxt, "stepTimer", riscv->stepTimer);
+        Bool wakeTimer = False;
+
+        // restore WFI wake-up timer if it was allocated when saved
+        vmirtRestore(cxt, "wakeTimerValid", &wakeTimer, sizeof(wakeTimer));
+
+        if(wakeTimer) {
+            newWakeTimer(riscv);
+            vmirtRestoreModelTimer(cxt, "wakeTimer", riscv->wakeTimer);
+        } else if(riscv->wakeTimer) {
+            vmirtClearModelTimer(riscv->wakeTimer);
         }
+
+        // restore single-step state
+        VMIRT_RESTORE_FIELD(cxt, riscv, stepPending);
+        riscvSetStepBreakpoint(riscv);
     }
 }
 
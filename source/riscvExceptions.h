@@ -46,6 +46,11 @@ void riscvTakeMemoryException(
     Uns64          tval
 );
 
+//
+// Return description of the given exception
+//
+const char *riscvGetExceptionDesc(riscvException exception, char *buffer);
+
 //
 // Reset the processor
 //
@@ -106,6 +111,11 @@ void riscvSetDMStall(riscvP riscv, Bool DMStall);
 //
 void riscvSetStepBreakpoint(riscvP riscv);
 
+//
+// Called before a single-stepped instruction executes
+//
+void riscvStepInstruction(riscvP riscv);
+
 //
 // Halt the processor in WFI state if required
 //
@@ -132,11 +142,26 @@ void riscvExceptFree(riscvP riscv);
 //
 void riscvUpdatePending(riscvP riscv);
 
+//
+// Apply any interrupt net changes deferred by batching
+//
+void riscvFlushPending(riscvP riscv);
+
 //
 // Check for pending interrupts
 //
 void riscvTestInterrupt(riscvP riscv);
 
+//
+// Refresh cached pending-and-enabled interrupt state
+//
+void riscvRefreshPendingAndEnabled(riscvP riscv);
+
+//
+// Refresh masks of interrupts delegated to each mode
+//
+void riscvRefreshInterruptDelegation(riscvP riscv);
+
 //
 // Allocate ports for this variant
 //
@@ -148,9 +173,9 @@ void riscvNewNetPorts(riscvP riscv);
 void riscvFreeNetPorts(riscvP riscv);
 
 //
-// Allocate timers
+// Specify the number of cycles after which a hart halted in WFI should resume
 //
-void riscvNewTimers(riscvP riscv);
+void riscvSetWFIWakeup(riscvP riscv, Uns64 cycles);
 
 //
 // Free timers
@@ -0,0 +1,413 @@
+/*
+ * Copyright (c) 2005-2020 Imperas Software Ltd., www.imperas.com
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied.
+ *
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+// standard header files
+#include <stdlib.h>
+#include <time.h>
+
+// Imperas header files
+#include "hostapi/impAlloc.h"
+
+// VMI header files
+#include "vmi/vmiMessage.h"
+#include "vmi/vmiRt.h"
+
+// model header files
+#include "riscvJITStats.h"
+#include "riscvStructure.h"
+#include "riscvUtils.h"
+
+
+////////////////////////////////////////////////////////////////////////////////
+// JIT STATISTICS STATE
+////////////////////////////////////////////////////////////////////////////////
+
+//
+// Number of hash buckets for translated block addresses (power of two)
+//
+#define JS_BUCKETS      4096
+
+//
+// Number of most-retranslated addresses reported
+//
+#define JS_TOP_N        16
+
+//
+// This enumerates the reasons a block at a previously-translated address is
+// translated again
+//
+typedef enum riscvRetranslateE {
+    RVRT_PMKEY,                 // polymorphic key changed
+    RVRT_MODE,                  // processor mode changed
+    RVRT_XLEN,                  // current XLEN changed
+    RVRT_FLUSH,                 // model flushed all translations
+    RVRT_CODE,                  // code modified or translation evicted
+    RVRT_LAST                   // KEEP LAST: for sizing
+} riscvRetranslate;
+
+//
+// Description of each retranslation reason
+//
+static const char *retranslateNames[RVRT_LAST] = {
+    [RVRT_PMKEY] = "polymorphic key",
+    [RVRT_MODE]  = "mode",
+    [RVRT_XLEN]  = "XLEN",
+    [RVRT_FLUSH] = "model flush",
+    [RVRT_CODE]  = "code change",
+};
+
+//
+// This holds translation history for one block start address
+//
+typedef struct riscvJITBlockS {
+    struct riscvJITBlockS *next;                // next in hash chain
+    Uns64                  startPC;             // block start address
+    Uns64                  flushCount;          // flush count at translation
+    Uns32                  pmKey;               // polymorphic key
+    Uns32                  retranslations;      // total retranslations
+    Uns32                  reason[RVRT_LAST];   // retranslations by reason
+    Uns8                   mode;                // processor mode
+    Uns8                   XLEN;                // current XLEN
+} riscvJITBlock, *riscvJITBlockP;
+
+//
+// This holds JIT translation statistics for a hart
+//
+typedef struct riscvJITStatsS {
+    Uns64          blocks;                      // blocks translated
+    Uns64          instructions;                // instructions translated
+    Uns64          flushes;                     // model flushes
+    Uns64          reason[RVRT_LAST];           // retranslations by reason
+    Uns64          distinct;                    // distinct block addresses
+    clock_t        time;                        // total translation time
+    clock_t        startTime;                   // start of current block
+    Uns32          depth;                       // block nesting depth
+    riscvJITBlockP buckets[JS_BUCKETS];         // block history
+} riscvJITStats;
+
+//
+// Return hash bucket index for the given block address
+//
+inline static Uns32 getBucket(Uns64 startPC) {
+    return ((startPC>>1) ^ (startPC>>13)) & (JS_BUCKETS-1);
+}
+
+//
+// Return the history entry for the given block address, or NULL if the
+// address has not been translated before
+//
+static riscvJITBlockP findBlock(riscvJITStatsP stats, Uns64 startPC) {
+
+    riscvJITBlockP block;
+
+    for(block=stats->buckets[getBucket(startPC)]; block; block=block->next) {
+        if(block->startPC==startPC) {
+            break;
+        }
+    }
+
+    return block;
+}
+
+//
+// Create a history entry for the given block address
+//
+static riscvJITBlockP newBlock(riscvJITStatsP stats, Uns64 startPC) {
+
+    riscvJITBlockP *bucket = &stats->buckets[getBucket(startPC)];
+    riscvJITBlockP  block  = STYPE_CALLOC(riscvJITBlock);
+
+    block->startPC = startPC;
+    block->next    = *bucket;
+    *bucket        = block;
+
+    stats->distinct++;
+
+    return block;
+}
+
+//
+// Return the reason a block with the given history is translated again
+//
+static riscvRetranslate getReason(
+    riscvP         riscv,
+    riscvJITStatsP stats,
+    riscvJITBlockP block
+) {
+    if(block->mode!=riscv->mode) {
+        return RVRT_MODE;
+    } else if(block->XLEN!=riscvGetXlenMode(riscv)) {
+        return RVRT_XLEN;
+    } else if(block->pmKey!=riscv->pmKey) {
+        return RVRT_PMKEY;
+    } else if(block->flushCount!=stats->flushes) {
+        return RVRT_FLUSH;
+    } else {
+        return RVRT_CODE;
+    }
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+// REPORTING
+////////////////////////////////////////////////////////////////////////////////
+
+//
+// Order blocks by decreasing retranslation count
+//
+static int compareBlocks(const void *va, const void *vb) {
+
+    riscvJITBlockP a = *(riscvJITBlockP *)va;
+    riscvJITBlockP b = *(riscvJITBlockP *)vb;
+
+    if(a->retranslations>b->retranslations) {
+        return -1;
+    } else if(a->retranslations<b->retranslations) {
+        return 1;
+    } else {
+        return (a->startPC<b->startPC) ? -1 : (a->startPC>b->startPC);
+    }
+}
+
+//
+// Report the most frequently retranslated block addresses
+//
+static void reportTopBlocks(riscvJITStatsP stats) {
+
+    riscvJITBlockP *sorted = STYPE_CALLOC_N(riscvJITBlockP, stats->distinct);
+    Uns32           num    = 0;
+    Uns32           i;
+
+    // collect all retranslated blocks
+    for(i=0; i<JS_BUCKETS; i++) {
+
+        riscvJITBlockP block;
+
+        for(block=stats->buckets[i]; block; block=block->next) {
+            if(block->retranslations) {
+                sorted[num++] = block;
+            }
+        }
+    }
+
+    qsort(sorted, num, sizeof(sorted[0]), compareBlocks);
+
+    if(num) {
+        vmiPrintf("  most retranslated addresses:\n");
+    }
+
+    for(i=0; (i<num) && (i<JS_TOP_N); i++) {
+
+        riscvJITBlockP   block = sorted[i];
+        riscvRetranslate reason;
+
+        vmiPrintf(
+            "    0x"FMT_6408x": %u",
+            block->startPC, block->retranslations
+        );
+
+        for(reason=0; reason<RVRT_LAST; reason++) {
+            if(block->reason[reason]) {
+                vmiPrintf(
+                    " (%s %u)",
+                    retranslateNames[reason], block->reason[reason]
+                );
+            }
+        }
+
+        vmiPrintf("\n");
+    }
+
+    STYPE_FREE(sorted);
+}
+
+//
+// Report JIT translation statistics for a hart
+//
+static void reportJITStats(riscvP riscv) {
+
+    riscvJITStatsP   stats = riscv->jitStats;
+    Uns64            total = 0;
+    riscvRetranslate reason;
+
+    for(reason=0; reason<RVRT_LAST; reason++) {
+        total += stats->reason[reason];
+    }
+
+    vmiPrintf(
+        "JIT STATISTICS (%s):\n", vmirtProcessorName((vmiProcessorP)riscv)
+    );
+    vmiPrintf("  blocks translated:  "FMT_64u"\n", stats->blocks);
+    vmiPrintf("  instructions:       "FMT_64u"\n", stats->instructions);
+    vmiPrintf("  distinct addresses: "FMT_64u"\n", stats->distinct);
+    vmiPrintf(
+        "  translation time:   %.3f ms (host CPU)\n",
+        (stats->time*1000.0)/CLOCKS_PER_SEC
+    );
+    vmiPrintf("  model flushes:      "FMT_64u"\n", stats->flushes);
+    vmiPrintf("  retranslations:     "FMT_64u"\n", total);
+
+    for(reason=0; reason<RVRT_LAST; reason++) {
+        if(stats->reason[reason]) {
+            vmiPrintf(
+                "    %-16s "FMT_64u"\n",
+                retranslateNames[reason], stats->reason[reason]
+            );
+        }
+    }
+
+    reportTopBlocks(stats);
+}
+
+//
+// Report JIT translation statistics
+//
+static VMIRT_COMMAND_PARSE_FN(jitStatsCommand) {
+
+    riscvP riscv = (riscvP)processor;
+
+    reportJITStats(riscv);
+
+    return "1";
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+// PUBLIC INTERFACE
+////////////////////////////////////////////////////////////////////////////////
+
+//
+// Allocate JIT translation statistics state if enabled
+//
+void riscvNewJITStats(riscvP riscv) {
+
+    if(riscv->configInfo.jit_stats) {
+
+        riscv->jitStats = STYPE_CALLOC(riscvJITStats);
+
+        // jitStats command
+        vmirtAddCommandParse(
+            (vmiProcessorP)riscv,
+            "jitStats",
+            "show translated block counts, translation time and "
+            "retranslation causes",
+            jitStatsCommand,
+            VMI_CT_QUERY|VMI_CO_CPU|VMI_CA_REPORT
+        );
+    }
+}
+
+//
+// Report and free JIT translation statistics state
+//
+void riscvFreeJITStats(riscvP riscv) {
+
+    riscvJITStatsP stats = riscv->jitStats;
+
+    if(stats) {
+
+        Uns32 i;
+
+        // report statistics at end of simulation
+        reportJITStats(riscv);
+
+        for(i=0; i<JS_BUCKETS; i++) {
+
+            riscvJITBlockP block;
+
+            while((block=stats->buckets[i])) {
+                stats->buckets[i] = block->next;
+                STYPE_FREE(block);
+            }
+        }
+
+        STYPE_FREE(stats);
+        riscv->jitStats = 0;
+    }
+}
+
+//
+// Record start of translation of a code block
+//
+void riscvJITStatsStartBlock(riscvP riscv) {
+
+    riscvJITStatsP stats = riscv->jitStats;
+
+    // time only the outermost block if translations are nested
+    if(!stats->depth++) {
+        stats->startTime = clock();
+    }
+}
+
+//
+// Record translation of an instruction
+//
+void riscvJITStatsInstruction(riscvP riscv) {
+
+    riscv->jitStats->instructions++;
+}
+
+//
+// Record end of translation of a code block starting at the given address
+//
+void riscvJITStatsEndBlock(riscvP riscv, Uns64 startPC, Bool startPCValid) {
+
+    riscvJITStatsP stats = riscv->jitStats;
+
+    if(!--stats->depth) {
+        stats->time += clock()-stats->startTime;
+    }
+
+    if(startPCValid) {
+
+        riscvJITBlockP block = findBlock(stats, startPC);
+
+        if(block) {
+
+            // classify retranslation of a previously-seen address
+            riscvRetranslate reason = getReason(riscv, stats, block);
+
+            block->retranslations++;
+            block->reason[reason]++;
+            stats->reason[reason]++;
+
+        } else {
+
+            // first translation at this address
+            block = newBlock(stats, startPC);
+        }
+
+        // record state in which the block was translated
+        block->flushCount = stats->flushes;
+        block->pmKey      = riscv->pmKey;
+        block->mode       = riscv->mode;
+        block->XLEN       = riscvGetXlenMode(riscv);
+
+        stats->blocks++;
+    }
+}
+
+//
+// Record flush of all translated code by the model
+//
+void riscvJITStatsFlush(riscvP riscv) {
+
+    riscv->jitStats->flushes++;
+}
+
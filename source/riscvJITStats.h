@@ -0,0 +1,57 @@
+/*
+ * Copyright (c) 2005-2020 Imperas Software Ltd., www.imperas.com
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied.
+ *
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#pragma once
+
+// VMI header files
+#include "vmi/vmiTypes.h"
+
+// model header files
+#include "riscvTypeRefs.h"
+
+//
+// Allocate JIT translation statistics state if enabled
+//
+void riscvNewJITStats(riscvP riscv);
+
+//
+// Report and free JIT translation statistics state
+//
+void riscvFreeJITStats(riscvP riscv);
+
+//
+// Record start of translation of a code block
+//
+void riscvJITStatsStartBlock(riscvP riscv);
+
+//
+// Record translation of an instruction
+//
+void riscvJITStatsInstruction(riscvP riscv);
+
+//
+// Record end of translation of a code block starting at the given address
+//
+void riscvJITStatsEndBlock(riscvP riscv, Uns64 startPC, Bool startPCValid);
+
+//
+// Record flush of all translated code by the model
+//
+void riscvJITStatsFlush(riscvP riscv);
+
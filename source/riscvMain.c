@@ -28,6 +28,7 @@
 
 // Model header files
 #include "riscvCluster.h"
+#include "riscvBinaryTrace.h"
 #include "riscvBus.h"
 #include "riscvConfig.h"
 #include "riscvCSR.h"
@@ -35,10 +36,14 @@
 #include "riscvDoc.h"
 #include "riscvExceptions.h"
 #include "riscvFunctions.h"
+#include "riscvJITStats.h"
 #include "riscvMessage.h"
 #include "riscvMorph.h"
 #include "riscvParameters.h"
+#include "riscvProfile.h"
 #include "riscvStructure.h"
+#include "riscvTrapStats.h"
+#include "riscvTrapTrace.h"
 #include "riscvUtils.h"
 #include "riscvVM.h"
 #include "riscvVMConstants.h"
@@ -73,6 +78,7 @@ static void initLeafModelCBs(riscvP riscv) {
     // from riscvExceptions.h
     riscv->cb.illegalInstruction = riscvIllegalInstruction;
     riscv->cb.takeException      = riscvTakeException;
+    riscv->cb.setWFIWakeup       = riscvSetWFIWakeup;
 
     // from riscvMorph.h
     riscv->cb.instructionEnabled = riscvInstructionEnabled;
@@ -241,6 +247,15 @@ static void applyParamsSMP(riscvP riscv, riscvParamValuesP params) {
     cfg->local_int_num     = params->local_int_num;
     cfg->unimp_int_mask    = params->unimp_int_mask;
     cfg->external_int_id   = params->external_int_id;
+    cfg->batch_interrupts  = params->batch_interrupts;
+    cfg->trap_stats        = params->trap_stats;
+    cfg->exception_trace   = params->exception_trace;
+    cfg->profile_interval  = params->profile_interval;
+    cfg->profile_unwind    = params->profile_unwind;
+    cfg->profile_file      = params->profile_file;
+    cfg->jit_stats         = params->jit_stats;
+    cfg->tlb_stats         = params->tlb_stats;
+    cfg->binary_trace      = params->binary_trace;
     cfg->no_ideleg         = params->no_ideleg;
     cfg->no_edeleg         = params->no_edeleg;
     cfg->lr_sc_grain       = powerOfTwo(params->lr_sc_grain, "lr_sc_grain");
@@ -250,6 +265,7 @@ static void applyParamsSMP(riscvP riscv, riscvParamValuesP params) {
     cfg->unaligned         = params->unaligned;
     cfg->unalignedAMO      = params->unalignedAMO;
     cfg->wfi_is_nop        = params->wfi_is_nop;
+    cfg->spin_yield        = params->spin_yield;
     cfg->mtvec_is_ro       = params->mtvec_is_ro;
     cfg->tvec_align        = params->tvec_align;
     cfg->tval_ii_code      = params->tval_ii_code;
@@ -371,6 +387,20 @@ static void applyParams(riscvP riscv, riscvParamValuesP params) {
     }
 }
 
+//
+// Reset the hart in place, retaining configuration and translation state
+// (allows a harness to run a batch of programs without reconstructing the
+// model for each one)
+//
+static VMIRT_COMMAND_PARSE_FN(resetHartCommand) {
+
+    riscvP riscv = (riscvP)processor;
+
+    riscvReset(riscv);
+
+    return "1";
+}
+
 //
 // RISCV processor constructor
 //
@@ -437,8 +467,29 @@ VMI_CONSTRUCTOR_FN(riscvConstructor) {
         // create root level bus port specifications for leaf level ports
         riscvNewLeafBusPorts(riscv);
 
-        // allocate timers
-        riscvNewTimers(riscv);
+        // allocate trap statistics
+        riscvNewTrapStats(riscv);
+
+        // allocate exception trace
+        riscvNewTrapTrace(riscv);
+
+        // allocate sampling profiler
+        riscvNewProfile(riscv);
+
+        // allocate JIT statistics
+        riscvNewJITStats(riscv);
+
+        // open binary trace
+        riscvNewBinaryTrace(riscv);
+
+        // resetHart command
+        vmirtAddCommandParse(
+            processor,
+            "resetHart",
+            "reset the hart in place (for batch runs of multiple programs)",
+            resetHartCommand,
+            VMI_CT_DEFAULT|VMI_CO_CPU|VMI_CA_CONTROL
+        );
 
         // do initial reset
         riscvReset(riscv);
@@ -454,6 +505,45 @@ VMI_CONSTRUCTOR_FN(riscvConstructor) {
     }
 }
 
+//
+// Is documentation required for the passed processor? Documentation for an
+// SMP container describes all its harts, so SMP members are not documented
+// separately; AMP cluster members are documented once for each distinct
+// variant
+//
+static Bool requireDoc(riscvP riscv) {
+
+    riscvP parent = riscv->parent;
+    Bool   result = True;
+
+    if(!parent) {
+
+        // root processor is always documented
+
+    } else if(!riscvIsCluster(parent)) {
+
+        // SMP member is documented by its container
+        result = False;
+
+    } else {
+
+        // cluster member is documented only if no earlier member of the
+        // cluster has the same variant
+        const char **members = parent->configInfo.members;
+        const char  *variant = riscvGetClusterVariant(riscv);
+        Uns32        index   = vmirtGetSMPIndex((vmiProcessorP)riscv);
+        Uns32        i;
+
+        for(i=0; i<index; i++) {
+            if(!strcmp(members[i], variant)) {
+                result = False;
+            }
+        }
+    }
+
+    return result;
+}
+
 //
 // RISCV processor post-constructor
 //
@@ -461,8 +551,10 @@ VMI_POST_CONSTRUCTOR_FN(riscvPostConstructor) {
 
     riscvP riscv = (riscvP)processor;
 
-    // install documentation after processor is initialized
-    riscvDoc(riscv);
+    // install documentation after processor is initialized if required
+    if(requireDoc(riscv)) {
+        riscvDoc(riscv);
+    }
 
     // create root level bus port specifications for root level ports
     riscvNewRootBusPorts(riscv);
@@ -501,6 +593,27 @@ VMI_DESTRUCTOR_FN(riscvDestructor) {
 
     // free timers
     riscvFreeTimers(riscv);
+
+    // free LR/SC reservation table
+    riscvFreeReservations(riscv);
+
+    // free extension callback dispatch tables
+    riscvFreeExtCBTables(riscv);
+
+    // report and free trap statistics
+    riscvFreeTrapStats(riscv);
+
+    // free exception trace
+    riscvFreeTrapTrace(riscv);
+
+    // write profile and free sampling profiler
+    riscvFreeProfile(riscv);
+
+    // report and free JIT statistics
+    riscvFreeJITStats(riscv);
+
+    // close binary trace
+    riscvFreeBinaryTrace(riscv);
 }
 
 
@@ -614,6 +727,12 @@ VMI_SAVE_STATE_FN(riscvSaveState) {
     // save net state not covered by register read/write API
     riscvNetSave(riscv, cxt, phase);
 
+    // save timer state not covered by register read/write API
+    riscvTimerSave(riscv, cxt, phase);
+
+    // save sampling profiler state
+    riscvProfileSave(riscv, cxt, phase);
+
     // end of SMP cluster
     if(phase==SRT_END) {
         vmirtIterAllProcessors(processor, endSave, 0);
@@ -666,6 +785,12 @@ VMI_RESTORE_STATE_FN(riscvRestoreState) {
     // restore net state not covered by register read/write API
     riscvNetRestore(riscv, cxt, phase);
 
+    // restore timer state not covered by register read/write API
+    riscvTimerRestore(riscv, cxt, phase);
+
+    // restore sampling profiler state
+    riscvProfileRestore(riscv, cxt, phase);
+
     // end of SMP cluster
     if(phase==SRT_END) {
         vmirtIterAllProcessors(processor, endRestore, 0);
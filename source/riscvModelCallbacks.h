@@ -41,7 +41,10 @@
 ////////////////////////////////////////////////////////////////////////////////
 
 //
-// Register extension callback block with the base model
+// Register extension callback block with the base model. The base model builds
+// per-event dispatch tables from the callbacks that are non-null at the time
+// of registration, so all callbacks in the block must be filled before it is
+// registered: a callback set in the block after registration is never called.
 //
 #define RISCV_REGISTER_EXT_CB_FN(_NAME) void _NAME( \
     riscvP      riscv,  \
@@ -119,6 +122,20 @@ typedef RISCV_ILLEGAL_INSTRUCTION_FN((*riscvIllegalInstructionFn));
 )
 typedef RISCV_TAKE_EXCEPTION_FN((*riscvTakeExceptionFn));
 
+//
+// Specify the number of cycles after which a hart halted in WFI should resume
+// (the time of the next event that could wake it); zero cancels any pending
+// wake-up. The caller is a derived model implementing a timer device, which
+// should pass the cycles remaining to the next timer compare event whenever
+// that time changes. The base model cancels the wake-up itself when an
+// interrupt ends the WFI and on reset.
+//
+#define RISCV_SET_WFI_WAKEUP_FN(_NAME) void _NAME( \
+    riscvP riscv,               \
+    Uns64  cycles               \
+)
+typedef RISCV_SET_WFI_WAKEUP_FN((*riscvSetWFIWakeupFn));
+
 //
 // Validate that the instruction is supported and enabled and take an Illegal
 // Instruction exception if not
@@ -331,6 +348,9 @@ typedef struct riscvModelCBS {
     // from riscvCSR.h
     riscvNewCSRFn             newCSR;
 
+    // from riscvExceptions.h (appended to preserve the layout above)
+    riscvSetWFIWakeupFn       setWFIWakeup;
+
 } riscvModelCB;
 
 //
@@ -26,12 +26,14 @@
 #include "vmi/vmiRt.h"
 
 // model header files
+#include "riscvBinaryTrace.h"
 #include "riscvBlockState.h"
 #include "riscvCSRTypes.h"
 #include "riscvDecode.h"
 #include "riscvDecodeTypes.h"
 #include "riscvExceptions.h"
 #include "riscvFunctions.h"
+#include "riscvJITStats.h"
 #include "riscvMessage.h"
 #include "riscvMorph.h"
 #include "riscvRegisters.h"
@@ -217,6 +219,96 @@ inline static void emitCheckPolymorphic(void) {
     vmimtPolymorphicBlock(16, RISCV_PM_KEY);
 }
 
+//
+// Emit single-step actions before an instruction if required
+//
+static void emitStepStart(riscvP riscv) {
+
+    // validate single-step state using polymorphic key
+    if(riscv->useStepKey) {
+        emitCheckPolymorphic();
+    }
+
+    // request Debug mode entry after this instruction if stepping
+    if(riscv->pmKey & PMK_STEP) {
+        vmimtArgProcessor();
+        vmimtCall((vmiCallFn)riscvStepInstruction);
+    }
+}
+
+//
+// Emit single-step actions after an instruction if required
+//
+static void emitStepEnd(riscvP riscv) {
+
+    // blocks translated while stepping hold a single instruction
+    if(riscv->pmKey & PMK_STEP) {
+        vmimtEndBlock();
+    }
+}
+
+//
+// Emit binary trace record of the instruction if required
+//
+static void emitBinaryTraceInstruction(riscvMorphStateP state) {
+
+    if(state->riscv->binaryTrace) {
+        vmimtArgProcessor();
+        vmimtArgUns64(state->info.thisPC);
+        vmimtArgUns32(state->info.instruction);
+        vmimtArgUns32(state->info.bytes);
+        vmimtCall((vmiCallFn)riscvBinaryTraceInstruction);
+    }
+}
+
+//
+// Emit binary trace of memory access address if required
+//
+static void emitBinaryTraceAddress(
+    riscvMorphStateP state,
+    vmiReg           ra,
+    Uns64            offset
+) {
+    if(state->riscv->binaryTrace) {
+        vmimtArgProcessor();
+        vmimtArgReg(64, ra);
+        vmimtArgUns64(offset);
+        vmimtCall((vmiCallFn)riscvBinaryTraceAddress);
+    }
+}
+
+//
+// Emit increment of the count for the given performance monitor event if it
+// is selected by any mhpmevent register (translations are flushed when the
+// set of selected events changes)
+//
+static void emitHPMEvent(riscvP riscv, riscvHPMEvent event) {
+
+    if(riscv->hpmEventMask & (1<<event)) {
+        vmimtBinopRC(64, vmi_ADD, RISCV_HPM_COUNT(event), 1, 0);
+    }
+}
+
+//
+// Emit increment of the count for the given performance monitor event if the
+// Boolean flag is set
+//
+static void emitHPMEventCond(
+    riscvMorphStateP state,
+    riscvHPMEvent    event,
+    vmiReg           flag
+) {
+    riscvP riscv = state->riscv;
+
+    if(riscv->hpmEventMask & (1<<event)) {
+
+        vmiReg tmp = newTmp(state);
+
+        vmimtMoveExtendRR(64, tmp, 8, flag, False);
+        vmimtBinopRR(64, vmi_ADD, RISCV_HPM_COUNT(event), tmp, 0);
+    }
+}
+
 //
 // Are only unit stride load/store instructions supported?
 //
@@ -1008,10 +1100,8 @@ static Uns64 doLoadTMode(riscvP riscv, Uns64 VA, Uns32 bytes) {
     riscvExtCBP extCB;
 
     // call derived model transaction load functions
-    for(extCB=riscv->extCBs; extCB; extCB=extCB->next) {
-        if(extCB->tLoad) {
-            extCB->tLoad(riscv, &result, VA, bytes, extCB->clientData);
-        }
+    RISCV_FOR_EACH_EXT_CB(riscv, RVECB_TLOAD, extCB) {
+        extCB->tLoad(riscv, &result, VA, bytes, extCB->clientData);
     }
 
     return result;
@@ -1025,10 +1115,8 @@ static void doStoreTMode(riscvP riscv, Uns64 VA, Uns64 value, Uns32 bytes) {
     riscvExtCBP extCB;
 
     // call derived model transaction store functions
-    for(extCB=riscv->extCBs; extCB; extCB=extCB->next) {
-        if(extCB->tStore) {
-            extCB->tStore(riscv, &value, VA, bytes, extCB->clientData);
-        }
+    RISCV_FOR_EACH_EXT_CB(riscv, RVECB_TSTORE, extCB) {
+        extCB->tStore(riscv, &value, VA, bytes, extCB->clientData);
     }
 }
 
@@ -1174,6 +1262,15 @@ static void emitLoadCommonMBO(
     Uns64            offset,
     memConstraint    constraint
 ) {
+    // note base register used by a load in the current block
+    noteSpinLoad(state, ra);
+
+    // count load event if required
+    emitHPMEvent(state->riscv, RV_HPM_LOAD);
+
+    // trace load address if required
+    emitBinaryTraceAddress(state, ra, offset);
+
     if(inTransactionMode(state)) {
         emitLoadTModeMBO(state, rdBits, memBits, offset, rd, ra, constraint);
     } else {
@@ -1192,6 +1289,15 @@ static void emitStoreCommonMBO(
     Uns64            offset,
     memConstraint    constraint
 ) {
+    // note that the current block contains a store
+    state->riscv->blockState->storeSeen = True;
+
+    // count store event if required
+    emitHPMEvent(state->riscv, RV_HPM_STORE);
+
+    // trace store address if required
+    emitBinaryTraceAddress(state, ra, offset);
+
     if(inTransactionMode(state)) {
         emitStoreTModeMBO(state, memBits, offset, ra, rs, constraint);
     } else {
@@ -1241,6 +1347,9 @@ static void emitTryStoreCommon(
     Uns32 memBits = state->info.memBits;
     Uns64 offset  = state->info.c;
 
+    // note that the current block contains a store
+    state->riscv->blockState->storeSeen = True;
+
     // generate Store/AMO exception in preference to Load exception
     vmimtTryStoreRC(memBits, offset, ra, constraint);
 }
@@ -1543,6 +1652,97 @@ static void checkTargetAddressAlignedR(
     }
 }
 
+//
+// Note that the current block contains a load using base register ra
+//
+static void noteSpinLoad(riscvMorphStateP state, vmiReg ra) {
+
+    riscvBlockStateP blockState = state->riscv->blockState;
+    Int32            index      = -1;
+    Uns32            i;
+
+    // get the GPR index of the base register (temporaries are unknown)
+    if(VMI_ISNOREG(ra)) {
+        index = 0;
+    } else {
+        for(i=1; (index<0) && (i<32); i++) {
+            if(VMI_REG_EQUAL(ra, RISCV_GPR(i))) {
+                index = i;
+            }
+        }
+    }
+
+    if(index<0) {
+        blockState->spinLoad = SPIN_LOAD_VARIES;
+    } else if(blockState->spinLoad==SPIN_LOAD_NONE) {
+        blockState->spinLoad = SPIN_LOAD_SAME;
+        blockState->spinBase = index;
+    } else if(blockState->spinBase!=index) {
+        blockState->spinLoad = SPIN_LOAD_VARIES;
+    }
+}
+
+//
+// Yield the remainder of the current quantum from a spin-wait loop
+//
+static void yieldSpinLoop(riscvP riscv) {
+    vmirtYield((vmiProcessorP)riscv);
+}
+
+//
+// Return True if a branch to the given target may close a spin-wait loop: the
+// loop body is exactly the current block, which reads memory but does not
+// write it, and all loads in the block use the same base register. Whether
+// the loop is really spinning is determined when the branch is taken by
+// emitSpinBaseCheck.
+//
+static Bool isSpinLoop(riscvMorphStateP state, Uns64 tgt) {
+
+    riscvP           riscv      = state->riscv;
+    riscvBlockStateP blockState = riscv->blockState;
+
+    return (
+        riscv->configInfo.spin_yield               &&
+        blockState->startPCValid                   &&
+        (blockState->startPC==tgt)                 &&
+        (blockState->spinLoad==SPIN_LOAD_SAME)     &&
+        !blockState->storeSeen
+    );
+}
+
+//
+// Emit code to jump to label 'noYield' unless the load base register has the
+// same value as when the loop branch was last taken. The load addresses of
+// consecutive iterations are then identical, so the loop is polling memory
+// that only another hart or device can change. Loops that make progress
+// through memory (for example, string searches and checksums) change the base
+// register on each iteration and do not yield. A loop reading the same
+// address while making progress in registers only (for example, a delay loop
+// reading a device register) is still classified as a spin-wait loop.
+//
+static void emitSpinBaseCheck(riscvMorphStateP state, vmiLabelP noYield) {
+
+    riscvP riscv = state->riscv;
+    Uns8   index = riscv->blockState->spinBase;
+    Uns32  bits  = riscvGetXlenMode(riscv);
+    vmiReg base  = RISCV_GPR(index);
+    vmiReg last  = RISCV_CPU_REG(spinBase);
+    vmiReg same  = newTmp(state);
+
+    // loads using x0 as base always access the same address
+    if(index) {
+
+        // compare base register with value on previous iteration
+        vmimtCompareRR(bits, vmi_COND_EQ, base, last, same);
+
+        // record value for next iteration
+        vmimtMoveRR(bits, last, base);
+
+        // skip yield if base register has changed
+        vmimtCondJumpLabel(same, False, noYield);
+    }
+}
+
 //
 // Branch based on register comparison
 //
@@ -1575,6 +1775,27 @@ static RISCV_MORPH_FN(emitBranchRR) {
         vmimtInsertLabel(noBranch);
     }
 
+    // yield remainder of quantum if a spin-wait loop iterates
+    if(isSpinLoop(state, tgt)) {
+
+        vmiLabelP noYield = vmimtNewLabel();
+
+        // skip yield if condition is False
+        vmimtCondJumpLabel(tmp, False, noYield);
+
+        // skip yield if load base register has changed since last iteration
+        emitSpinBaseCheck(state, noYield);
+
+        vmimtArgProcessor();
+        vmimtCall((vmiCallFn)yieldSpinLoop);
+
+        // here if branch not taken
+        vmimtInsertLabel(noYield);
+    }
+
+    // count taken branch event if required
+    emitHPMEventCond(state, RV_HPM_BRANCH_TAKEN, tmp);
+
     // do branch
     vmimtCondJump(tmp, True, 0, tgt, VMI_NOREG, vmi_JH_RELATIVE);
 }
@@ -1613,6 +1834,9 @@ static RISCV_MORPH_FN(emitJAL) {
         emitTargetAddressUnalignedC(riscv, tgt);
     }
 
+    // count taken branch event if required
+    emitHPMEvent(riscv, RV_HPM_BRANCH_TAKEN);
+
     // emit call using calculated linkPC and adjusted lr
     Uns64 linkPC = getLinkPC(state, &lr);
     vmimtUncondJump(linkPC, tgt, lr, hint|vmi_JH_RELATIVE);
@@ -1651,6 +1875,9 @@ static RISCV_MORPH_FN(emitJALR) {
         hint = vmi_JH_NONE;
     }
 
+    // count taken branch event if required
+    emitHPMEvent(riscv, RV_HPM_BRANCH_TAKEN);
+
     // emit call using calculated linkPC and adjusted lr
     Uns64 linkPC = getLinkPC(state, &lr);
     vmimtUncondJumpReg(linkPC, ra, lr, hint|vmi_JH_RELATIVE);
@@ -1696,6 +1923,9 @@ static void emitAMOCommonInt(
     // this is an atomic operation
     vmimtAtomic();
 
+    // count AMO event if required
+    emitHPMEvent(state->riscv, RV_HPM_AMO);
+
     // generate Store/AMO exception in preference to Load exception
     emitTryStoreCommon(state, ra, constraint);
 
@@ -2134,6 +2364,9 @@ static void emitCSRRCommon(riscvMorphStateP state, vmiReg rs1, Bool write) {
             EMIT_TRAP_MASK_FIELD(riscv, mstatus, TVM, 1);
         }
 
+        // count CSR access event if required
+        emitHPMEvent(riscv, RV_HPM_CSR);
+
         // emit code to read the CSR if required
         if(read) {
             riscvEmitCSRRead(attrs, riscv, rdTmp, write);
@@ -3597,21 +3830,46 @@ static RISCV_MORPH_FN(emitFClass) {
 // VECTOR UNIT CONFIGURATION
 ////////////////////////////////////////////////////////////////////////////////
 
+//
+// Can the LMULx2, LMULx4 and LMULx8 index tables of the prototype be shared
+// by the passed hart? The tables depend only on VLEN and SLEN.
+//
+static Bool shareVectorIndices(riscvP riscv, riscvP prototype) {
+    return (
+        prototype &&
+        prototype->offsetsLMULx2 &&
+        (prototype->configInfo.VLEN==riscv->configInfo.VLEN) &&
+        (prototype->configInfo.SLEN==riscv->configInfo.SLEN)
+    );
+}
+
 //
 // Configure vector extension
 //
 void riscvConfigureVector(riscvP riscv) {
 
-    Uns32 vRegBytes   = riscv->configInfo.VLEN/8;
-    Uns32 stripeBytes = riscv->configInfo.SLEN/8;
+    Uns32  vRegBytes   = riscv->configInfo.VLEN/8;
+    Uns32  stripeBytes = riscv->configInfo.SLEN/8;
+    riscvP prototype   = riscvGetSMPPrototype(riscv);
 
     // allocate vector registers if required
     if(riscv->configInfo.arch & ISA_V) {
         riscv->v = STYPE_CALLOC_N(Uns32, (vRegBytes/4)*VREG_NUM);
     }
 
-    // allocate LMULx2, LMULx4 and LMULx8 index tables if required
-    if((riscv->configInfo.arch & ISA_V) && (vRegBytes!=stripeBytes)) {
+    if(!(riscv->configInfo.arch & ISA_V) || (vRegBytes==stripeBytes)) {
+
+        // no LMULx2, LMULx4 and LMULx8 index tables required
+
+    } else if(shareVectorIndices(riscv, prototype)) {
+
+        // share read-only index tables with SMP peer
+        riscv->offsetsLMULx2 = prototype->offsetsLMULx2;
+        riscv->offsetsLMULx4 = prototype->offsetsLMULx4;
+        riscv->offsetsLMULx8 = prototype->offsetsLMULx8;
+        riscv->sharedVIndex  = True;
+
+    } else {
 
         Uns32 stripes = vRegBytes/stripeBytes;
         Uns32 stripe;
@@ -3707,7 +3965,7 @@ void riscvFreeVector(riscvP riscv) {
     }
 
     // free LMULx2, LMULx4 and LMULx8 index tables if required
-    if(riscv->offsetsLMULx2) {
+    if(riscv->offsetsLMULx2 && !riscv->sharedVIndex) {
         STYPE_FREE(riscv->offsetsLMULx2);
         STYPE_FREE(riscv->offsetsLMULx4);
         STYPE_FREE(riscv->offsetsLMULx8);
@@ -3735,6 +3993,7 @@ typedef struct baseDescS {
 typedef struct iterDescS {
     riscvVLMULMt VLMUL;                 // effective VLMUL
     riscvSEWMt   SEW;                   // effective SEW
+    riscvVXRMMt  VXRM;                  // effective fixed point rounding mode
     Uns32        MLEN;                  // effective MLEN
     Uns32        SLEN;                  // effective SLEN
     Uns32        VLEN;                  // effective VLEN
@@ -4372,6 +4631,25 @@ static riscvSEWMt getSEWMt(riscvMorphStateP state) {
     return SEW;
 }
 
+//
+// Get effective fixed point rounding mode
+//
+static riscvVXRMMt getVXRMMt(riscvMorphStateP state) {
+
+    riscvP           riscv      = state->riscv;
+    riscvBlockStateP blockState = riscv->blockState;
+    riscvVXRMMt      VXRM       = blockState->VXRMMt;
+
+    if(VXRM==VXRMMT_UNKNOWN) {
+
+        emitCheckPolymorphic();
+
+        blockState->VXRMMt = VXRM = RD_CSR_FIELD(riscv, vxrm, rm) + VXRMMT_RNU;
+    }
+
+    return VXRM;
+}
+
 //
 // Get effective zero/non-zero/max vector length
 //
@@ -5647,6 +5925,11 @@ static riscvVLClassMt fillVectorOperationData(
         vlClass   = getVLClassMt(state, id);
     }
 
+    // get fixed point rounding mode if required
+    if(usesVXRM(state->attrs->vShape)) {
+        id->VXRM = getVXRMMt(state);
+    }
+
     // do actions required when SEW is forced to 8
     if(forceSEW8(state, id)) {
 
@@ -7355,110 +7638,54 @@ static RISCV_MORPHV_FN(emitVRMAccIntCB) {
 ////////////////////////////////////////////////////////////////////////////////
 
 //
-// Fixed point rounding modes
+// Fixed point rounding modes (as known at morph time)
 //
 typedef enum vxrmE {
-    VXRM_RNU,   // round-to-nearest-up
-    VXRM_RNE,   // round-to-nearest-even
-    VXRM_RDN,   // round-down (truncate)
-    VXRM_ROD,   // round-to-odd (jam)
+    VXRM_RNU = VXRMMT_RNU,  // round-to-nearest-up
+    VXRM_RNE = VXRMMT_RNE,  // round-to-nearest-even
+    VXRM_RDN = VXRMMT_RDN,  // round-down (truncate)
+    VXRM_ROD = VXRMMT_ROD,  // round-to-odd (jam)
 } vxrm;
 
-//
-// Define function returning fixed-point rounding adjustment for result of the
-// given bit size
-//
-#define FPRM_FUNC(_NAME, _BITS) Uns##_BITS _NAME(           \
-    Uns32      fprm,                                        \
-    Uns##_BITS result,                                      \
-    Uns##_BITS discard                                      \
-) {                                                         \
-    Uns##_BITS msbMask = 1ULL<<((_BITS)-1);                 \
-    Bool       vd      = result & 1;                        \
-    Bool       vdm1    = discard & msbMask;                 \
-    Bool       round;                                       \
-                                                            \
-    switch(fprm) {                                          \
-        case VXRM_RNU:                                      \
-            round = vdm1;                                   \
-            break;                                          \
-        case VXRM_RNE:                                      \
-            round = (discard==msbMask) ? vd : vdm1;         \
-            break;                                          \
-        case VXRM_RDN:                                      \
-            round = 0;                                      \
-            break;                                          \
-        case VXRM_ROD:                                      \
-            round = !vd && discard;                         \
-            break;                                          \
-        default:                                            \
-            VMI_ABORT("Unexpected rounding mode %u", fprm); \
-            break;                                          \
-    }                                                       \
-                                                            \
-    return round;                                           \
-}
-
-//
-// Define rounding adjustment functions
-//
-static FPRM_FUNC(getRound8,  8)
-static FPRM_FUNC(getRound16, 16)
-static FPRM_FUNC(getRound32, 32)
-static FPRM_FUNC(getRound64, 64)
-
-//
-// Return fixed-point rounding adjustment function for result of the given bit
-// size
-//
-static vmiCallFn getRoundCB(Uns32 bits) {
-
-    void *result = 0;
-
-    switch(bits) {
-        case 8:
-            result = getRound8;
-            break;
-        case 16:
-            result = getRound16;
-            break;
-        case 32:
-            result = getRound32;
-            break;
-        case 64:
-            result = getRound64;
-            break;
-        default:
-            VMI_ABORT("Unexpected bits %u", bits);  // LCOV_EXCL_LINE
-    }
-
-    return result;
-}
-
 
 ////////////////////////////////////////////////////////////////////////////////
 // VECTOR FIXED POINT ARITHMETIC INSTRUCTIONS
 ////////////////////////////////////////////////////////////////////////////////
 
 //
-// Emit code to get the fixed point rounding adjustment to apply in 'discard'
+// Emit code to round result in rd to nearest even using discarded bits in
+// discard (held left-aligned, so the most significant discarded bit is the top
+// bit)
 //
-static void emitGetFixedPointRoundingAdjust(
-    iterDescP id,
-    vmiReg    rd,
-    vmiReg    discard
+static void emitRoundNearestEven(
+    riscvMorphStateP state,
+    iterDescP        id,
+    vmiReg           rd,
+    vmiReg           discard
 ) {
-    Uns32 bits = id->SEW;
+    Uns32  bits = id->SEW;
+    vmiReg t0   = newTmp(state);
+
+    // t0 = (discard[MSB-1:0]!=0) | rd[0]
+    vmimtBinopRRC(bits, vmi_SHL, t0, discard, 1, 0);
+    vmimtCompareRC(bits, vmi_COND_NE, t0, 0, t0);
+    vmimtMoveExtendRR(bits, t0, 8, t0, False);
+    vmimtBinopRR(bits, vmi_OR, t0, rd, 0);
+
+    // round = discard[MSB] & t0[0]
+    vmimtBinopRC(bits, vmi_SHR, discard, bits-1, 0);
+    vmimtBinopRR(bits, vmi_AND, discard, t0, 0);
+    vmimtBinopRR(bits, vmi_ADD, rd, discard, 0);
 
-    vmimtArgReg(32, CSR_REG_MT(vxrm));
-    vmimtArgReg(bits, rd);
-    vmimtArgReg(bits, discard);
-    vmimtCallResultAttrs(getRoundCB(bits), bits, discard, VMCA_PURE);
+    freeTmp(state);
 }
 
 //
 // Emit code to round result in rd using discarded bits in discard using the
-// current fixed point rounding mode
+// current fixed point rounding mode. The discarded bits are held left-aligned
+// in discard (so the most significant discarded bit is the top bit); discard
+// is corrupted. Because vxrm is part of the polymorphic block key, the rounding
+// mode is known at morph time and the rounding increment is generated inline.
 //
 static void emitFixedPointRounding(
     riscvMorphStateP state,
@@ -7466,11 +7693,36 @@ static void emitFixedPointRounding(
     vmiReg           rd,
     vmiReg           discard
 ) {
-    // get rounding amount to add
-    emitGetFixedPointRoundingAdjust(id, rd, discard);
+    Uns32 bits = id->SEW;
+
+    switch(id->VXRM) {
+
+        case VXRM_RNU:
+            // round = discard[MSB]
+            vmimtBinopRC(bits, vmi_SHR, discard, bits-1, 0);
+            vmimtBinopRR(bits, vmi_ADD, rd, discard, 0);
+            break;
+
+        case VXRM_RNE:
+            emitRoundNearestEven(state, id, rd, discard);
+            break;
+
+        case VXRM_RDN:
+            // truncate: no adjustment
+            break;
+
+        case VXRM_ROD:
+            // jam: adding !rd[0] & (discard!=0) is equivalent to OR-ing
+            // (discard!=0) into rd[0]
+            vmimtCompareRC(bits, vmi_COND_NE, discard, 0, discard);
+            vmimtMoveExtendRR(bits, discard, 8, discard, False);
+            vmimtBinopRR(bits, vmi_OR, rd, discard, 0);
+            break;
 
-    // do  addition of rounding amount
-    vmimtBinopRR(id->SEW, vmi_ADD, rd, discard, 0);
+        default:
+            VMI_ABORT("Unexpected rounding mode %u", id->VXRM); // LCOV_EXCL_LINE
+            break;
+    }
 }
 
 //
@@ -8862,15 +9114,27 @@ VMI_START_END_BLOCK_FN(riscvStartBlock) {
     thisState->SEWMt                  = SEWMT_UNKNOWN;
     thisState->VLMULMt                = VLMULMT_UNKNOWN;
     thisState->VLClassMt              = VLCLASSMT_UNKNOWN;
+    thisState->VXRMMt                 = VXRMMT_UNKNOWN;
     thisState->VZeroTopMt[VTZ_SINGLE] = 0;
     thisState->VZeroTopMt[VTZ_GROUP]  = 0;
     thisState->VStartZeroMt           = forceVStart0(riscv);
 
+    // block contents are not known initially
+    thisState->startPCValid = False;
+    thisState->spinLoad     = SPIN_LOAD_NONE;
+    thisState->storeSeen    = False;
+
+    // record translation statistics if required
+    if(riscv->jitStats) {
+        riscvJITStatsStartBlock(riscv);
+    }
+
     // inherit any previously-active SEW, VLMUL and VLClass
     if(prevState) {
         thisState->SEWMt     = prevState->SEWMt;
         thisState->VLMULMt   = prevState->VLMULMt;
         thisState->VLClassMt = prevState->VLClassMt;
+        thisState->VXRMMt    = prevState->VXRMMt;
     }
 }
 
@@ -8888,6 +9152,13 @@ VMI_START_END_BLOCK_FN(riscvEndBlock) {
         "unexpected mismatched blockState at end of block"
     );
 
+    // record translation statistics if required
+    if(riscv->jitStats) {
+        riscvJITStatsEndBlock(
+            riscv, thisState->startPC, thisState->startPCValid
+        );
+    }
+
     // restore previously-active block state
     riscv->blockState = thisState->prevState;
 }
@@ -8903,6 +9174,12 @@ VMI_MORPH_FN(riscvMorph) {
     // get instruction and instruction type
     riscvDecode(riscv, thisPC, &state.info);
 
+    // record address of the first instruction in the block
+    if(!riscv->blockState->startPCValid) {
+        riscv->blockState->startPC      = thisPC;
+        riscv->blockState->startPCValid = True;
+    }
+
     // fill JIT translation state
     state.attrs       = &dispatchTable[state.info.type];
     state.riscv       = riscv;
@@ -8924,6 +9201,21 @@ VMI_MORPH_FN(riscvMorph) {
         state.info.arch |= ISA_FS;
     }
 
+    // handle single-step if required (before any instruction exception)
+    if(!disableMorph(&state)) {
+        emitStepStart(riscv);
+    }
+
+    // record translation statistics if required
+    if(riscv->jitStats && !disableMorph(&state)) {
+        riscvJITStatsInstruction(riscv);
+    }
+
+    // record instruction in binary trace if required
+    if(!disableMorph(&state)) {
+        emitBinaryTraceInstruction(&state);
+    }
+
     if(disableMorph(&state)) {
 
         // no action if in disassembly mode
@@ -8942,10 +9234,16 @@ VMI_MORPH_FN(riscvMorph) {
         riscvExtCBP extCB;
 
         // call derived model preMorph functions if required
-        for(extCB=riscv->extCBs; extCB; extCB=extCB->next) {
-            if(extCB->preMorph) {
-                extCB->preMorph(riscv, extCB->clientData);
-            }
+        RISCV_FOR_EACH_EXT_CB(riscv, RVECB_PRE_MORPH, extCB) {
+            extCB->preMorph(riscv, extCB->clientData);
+        }
+
+        // count floating point and vector events if required
+        if(state.info.arch & ISA_DF) {
+            emitHPMEvent(riscv, RV_HPM_FP);
+        }
+        if(state.info.arch & ISA_V) {
+            emitHPMEvent(riscv, RV_HPM_VECTOR);
         }
 
         // translate the instruction
@@ -8953,12 +9251,13 @@ VMI_MORPH_FN(riscvMorph) {
         state.attrs->morph(&state);
 
         // call derived model postMorph functions if required
-        for(extCB=riscv->extCBs; extCB; extCB=extCB->next) {
-            if(extCB->postMorph) {
-                extCB->postMorph(riscv, extCB->clientData);
-            }
+        RISCV_FOR_EACH_EXT_CB(riscv, RVECB_POST_MORPH, extCB) {
+            extCB->postMorph(riscv, extCB->clientData);
         }
 
+        // terminate single-stepped block if required
+        emitStepEnd(riscv);
+
     } else {
 
         // here if no morph callback specified
@@ -359,6 +359,7 @@ static RISCV_BOOL_PDEFAULT_CFG_FN(updatePTED);
 static RISCV_BOOL_PDEFAULT_CFG_FN(unaligned);
 static RISCV_BOOL_PDEFAULT_CFG_FN(unalignedAMO);
 static RISCV_BOOL_PDEFAULT_CFG_FN(wfi_is_nop);
+static RISCV_BOOL_PDEFAULT_CFG_FN(spin_yield);
 static RISCV_BOOL_PDEFAULT_CFG_FN(mtvec_is_ro);
 static RISCV_BOOL_PDEFAULT_CFG_FN(tval_ii_code);
 static RISCV_BOOL_PDEFAULT_CFG_FN(cycle_undefined);
@@ -369,6 +370,11 @@ static RISCV_BOOL_PDEFAULT_CFG_FN(d_requires_f);
 static RISCV_BOOL_PDEFAULT_CFG_FN(xret_preserves_lr);
 static RISCV_BOOL_PDEFAULT_CFG_FN(require_vstart0);
 static RISCV_BOOL_PDEFAULT_CFG_FN(external_int_id);
+static RISCV_BOOL_PDEFAULT_CFG_FN(batch_interrupts);
+static RISCV_BOOL_PDEFAULT_CFG_FN(trap_stats);
+static RISCV_BOOL_PDEFAULT_CFG_FN(profile_unwind);
+static RISCV_BOOL_PDEFAULT_CFG_FN(jit_stats);
+static RISCV_BOOL_PDEFAULT_CFG_FN(tlb_stats);
 static RISCV_BOOL_PDEFAULT_CFG_FN(CLICANDBASIC);
 static RISCV_BOOL_PDEFAULT_CFG_FN(CLICSELHVEC);
 static RISCV_BOOL_PDEFAULT_CFG_FN(CLICMNXTI);
@@ -381,6 +387,8 @@ static RISCV_UNS32_PDEFAULT_CFG_FN(tvec_align);
 static RISCV_UNS32_PDEFAULT_CFG_FN(PMP_grain)
 static RISCV_UNS32_PDEFAULT_CFG_FN(PMP_registers);
 static RISCV_UNS32_PDEFAULT_CFG_FN(CLICLEVELS);
+static RISCV_UNS32_PDEFAULT_CFG_FN(exception_trace);
+static RISCV_UNS32_PDEFAULT_CFG_FN(profile_interval);
 static RISCV_UNS32_PDEFAULT_CFG_FN(CLICCFGLBITS);
 
 //
@@ -580,6 +588,7 @@ static riscvParameter parameters[] = {
     {  RVPV_ALL,     default_unaligned,            VMI_BOOL_PARAM_SPEC  (riscvParamValues, unaligned,            False,                     "Specify whether the processor supports unaligned memory accesses")},
     {  RVPV_A,       default_unalignedAMO,         VMI_BOOL_PARAM_SPEC  (riscvParamValues, unalignedAMO,         False,                     "Specify whether the processor supports unaligned memory accesses for AMO instructions")},
     {  RVPV_ALL,     default_wfi_is_nop,           VMI_BOOL_PARAM_SPEC  (riscvParamValues, wfi_is_nop,           False,                     "Specify whether WFI should be treated as a NOP (if not, halt while waiting for interrupts)")},
+    {  RVPV_ALL,     default_spin_yield,           VMI_BOOL_PARAM_SPEC  (riscvParamValues, spin_yield,           False,                     "Specify whether spin-wait loops (backward branches closing a block that repeatedly loads from the same address and does not store) yield the remainder of the quantum")},
     {  RVPV_ALL,     default_mtvec_is_ro,          VMI_BOOL_PARAM_SPEC  (riscvParamValues, mtvec_is_ro,          False,                     "Specify whether mtvec CSR is read-only")},
     {  RVPV_ALL,     default_tvec_align,           VMI_UNS32_PARAM_SPEC (riscvParamValues, tvec_align,           0, 0,          (1<<16),    "Specify hardware-enforced alignment of mtvec/stvec/utvec when Vectored interrupt mode enabled")},
     {  RVPV_ALL,     default_mtvec_mask,           VMI_UNS64_PARAM_SPEC (riscvParamValues, mtvec_mask,           0, 0,          -1,         "Specify hardware-enforced mask of writable bits in mtvec register")},
@@ -608,6 +617,15 @@ static riscvParameter parameters[] = {
     {  RVPV_ALL,     default_no_ideleg,            VMI_UNS64_PARAM_SPEC (riscvParamValues, no_ideleg,            0, 0,          -1,         "Specify mask of interrupts that cannot be delegated to lower-priority execution levels")},
     {  RVPV_ALL,     default_no_edeleg,            VMI_UNS64_PARAM_SPEC (riscvParamValues, no_edeleg,            0, 0,          -1,         "Specify mask of exceptions that cannot be delegated to lower-priority execution levels")},
     {  RVPV_ALL,     default_external_int_id,      VMI_BOOL_PARAM_SPEC  (riscvParamValues, external_int_id,      False,                     "Whether to add nets allowing External Interrupt ID codes to be forced")},
+    {  RVPV_ALL,     default_batch_interrupts,     VMI_BOOL_PARAM_SPEC  (riscvParamValues, batch_interrupts,     False,                     "Whether interrupt net changes are batched, updating pending state once before the next instruction fetch")},
+    {  RVPV_ALL,     default_exception_trace,      VMI_UNS32_PARAM_SPEC (riscvParamValues, exception_trace,      0, 0,          (1<<20),    "Specify the number of entries in the exception trace ring buffer (0 disables the trace)")},
+    {  RVPV_ALL,     default_trap_stats,           VMI_BOOL_PARAM_SPEC  (riscvParamValues, trap_stats,           False,                     "Whether to record trap counts, interrupt latency and handler residency statistics")},
+    {  RVPV_ALL,     default_profile_interval,     VMI_UNS32_PARAM_SPEC (riscvParamValues, profile_interval,     0, 0,          -1,         "Specify the number of instructions between guest PC samples taken by the sampling profiler (0 disables the profiler)")},
+    {  RVPV_ALL,     default_profile_unwind,       VMI_BOOL_PARAM_SPEC  (riscvParamValues, profile_unwind,       False,                     "Whether the sampling profiler unwinds the guest frame pointer chain to record call stacks")},
+    {  RVPV_ALL,     0,                            VMI_STRING_PARAM_SPEC(riscvParamValues, profile_file,         "",                        "Specify the file prefix for sampling profiler output (the hart name is appended; if empty, the profile is written to the simulator log)")},
+    {  RVPV_ALL,     default_jit_stats,            VMI_BOOL_PARAM_SPEC  (riscvParamValues, jit_stats,            False,                     "Whether to record JIT translation counts, translation time and retranslation causes")},
+    {  RVPV_ALL,     default_tlb_stats,            VMI_BOOL_PARAM_SPEC  (riscvParamValues, tlb_stats,            False,                     "Whether to report TLB miss and page table walk counts")},
+    {  RVPV_ALL,     0,                            VMI_STRING_PARAM_SPEC(riscvParamValues, binary_trace,         "",                        "Specify the file prefix for a compact binary instruction trace (the hart name is appended; if empty, no binary trace is written)")},
 
     // fundamental configuration
     {  RVPV_ALL,     0,                            VMI_ENDIAN_PARAM_SPEC(riscvParamValues, endian,                                          "Model endian")},
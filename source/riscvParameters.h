@@ -47,6 +47,7 @@ typedef struct riscvParamValuesS {
     VMI_BOOL_PARAM(unaligned);
     VMI_BOOL_PARAM(unalignedAMO);
     VMI_BOOL_PARAM(wfi_is_nop);
+    VMI_BOOL_PARAM(spin_yield);
     VMI_BOOL_PARAM(mtvec_is_ro);
     VMI_UNS32_PARAM(tvec_align);
     VMI_UNS64_PARAM(mtvec_mask);
@@ -75,6 +76,15 @@ typedef struct riscvParamValuesS {
     VMI_UNS64_PARAM(no_ideleg);
     VMI_UNS64_PARAM(no_edeleg);
     VMI_BOOL_PARAM(external_int_id);
+    VMI_BOOL_PARAM(batch_interrupts);
+    VMI_BOOL_PARAM(trap_stats);
+    VMI_UNS32_PARAM(exception_trace);
+    VMI_UNS32_PARAM(profile_interval);
+    VMI_BOOL_PARAM(profile_unwind);
+    VMI_STRING_PARAM(profile_file);
+    VMI_BOOL_PARAM(jit_stats);
+    VMI_BOOL_PARAM(tlb_stats);
+    VMI_STRING_PARAM(binary_trace);
 
     // fundamental configuration
     VMI_ENDIAN_PARAM(endian);
@@ -0,0 +1,444 @@
+/*
+ * Copyright (c) 2005-2020 Imperas Software Ltd., www.imperas.com
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied.
+ *
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+// standard header files
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Imperas header files
+#include "hostapi/impAlloc.h"
+
+// VMI header files
+#include "vmi/vmiMessage.h"
+#include "vmi/vmiRt.h"
+
+// model header files
+#include "riscvMessage.h"
+#include "riscvProfile.h"
+#include "riscvStructure.h"
+#include "riscvUtils.h"
+
+
+////////////////////////////////////////////////////////////////////////////////
+// PROFILER STATE
+////////////////////////////////////////////////////////////////////////////////
+
+//
+// Maximum number of frames recorded for each sample
+//
+#define PROFILE_DEPTH   32
+
+//
+// Number of hash buckets for distinct stacks (power of two)
+//
+#define PROFILE_BUCKETS 4096
+
+//
+// Register holding the frame pointer (s0)
+//
+#define RV_REG_X_FP     8
+
+//
+// This holds the sample count for one distinct stack
+//
+typedef struct riscvProfileStackS {
+    struct riscvProfileStackS *next;                // next in hash chain
+    Uns64                      count;               // number of samples
+    Uns32                      depth;               // number of frames
+    Uns64                      pc[PROFILE_DEPTH];   // frames (innermost first)
+} riscvProfileStack, *riscvProfileStackP;
+
+//
+// This holds sampling profiler state for a hart
+//
+typedef struct riscvProfileS {
+    vmiModelTimerP     timer;                       // sample timer
+    Uns32              interval;                    // sample interval
+    Uns64              samples;                     // total samples
+    char              *file;                        // output file prefix
+    riscvProfileStackP buckets[PROFILE_BUCKETS];    // distinct stacks
+} riscvProfile;
+
+//
+// Return the number of bytes in a guest pointer
+//
+inline static Uns32 getPointerBytes(riscvP riscv) {
+    return riscvGetXlenMode(riscv)/8;
+}
+
+//
+// Return hash of the given stack
+//
+static Uns32 hashStack(Uns64 *pc, Uns32 depth) {
+
+    Uns64 hash = depth;
+    Uns32 i;
+
+    for(i=0; i<depth; i++) {
+        hash = (hash ^ pc[i]) * 0x9e3779b97f4a7c15ULL;
+    }
+
+    return (hash >> 32) & (PROFILE_BUCKETS-1);
+}
+
+//
+// Add a sample for the given stack
+//
+static void addSample(riscvProfileP profile, Uns64 *pc, Uns32 depth) {
+
+    riscvProfileStackP *bucket = &profile->buckets[hashStack(pc, depth)];
+    riscvProfileStackP  stack;
+
+    // find any existing entry for this stack
+    for(stack=*bucket; stack; stack=stack->next) {
+        if(
+            (stack->depth==depth) &&
+            !memcmp(stack->pc, pc, depth*sizeof(pc[0]))
+        ) {
+            break;
+        }
+    }
+
+    // create new entry if required
+    if(!stack) {
+
+        stack = STYPE_CALLOC(riscvProfileStack);
+
+        stack->depth = depth;
+        memcpy(stack->pc, pc, depth*sizeof(pc[0]));
+
+        stack->next = *bucket;
+        *bucket     = stack;
+    }
+
+    stack->count++;
+    profile->samples++;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+// SAMPLING
+////////////////////////////////////////////////////////////////////////////////
+
+//
+// Read a pointer-sized value from guest memory as an artifact access,
+// returning False if the address is misaligned
+//
+static Bool readGuestPointer(riscvP riscv, Uns64 address, Uns64 *value) {
+
+    vmiProcessorP processor = (vmiProcessorP)riscv;
+    memDomainP    domain    = vmirtGetProcessorDataDomain(processor);
+    memEndian     endian    = riscvGetCurrentDataEndian(riscv);
+    Uns32         bytes     = getPointerBytes(riscv);
+
+    if(address & (bytes-1)) {
+        return False;
+    }
+
+    riscv->artifactAccess = True;
+
+    if(bytes==4) {
+        *value = vmirtRead4ByteDomain(domain, address, endian, MEM_AA_FALSE);
+    } else {
+        *value = vmirtRead8ByteDomain(domain, address, endian, MEM_AA_FALSE);
+    }
+
+    riscv->artifactAccess = False;
+
+    return True;
+}
+
+//
+// Fill the current stack, innermost frame first, unwinding the frame pointer
+// chain if required (with frame pointers, the return address is saved one
+// word below the frame pointer and the caller's frame pointer two words below)
+//
+static Uns32 getStack(riscvP riscv, Uns64 *pc) {
+
+    Uns32 depth = 0;
+
+    pc[depth++] = vmirtGetPC((vmiProcessorP)riscv);
+
+    if(riscv->configInfo.profile_unwind) {
+
+        Uns64 bytes = getPointerBytes(riscv);
+        Uns64 fp    = riscv->x[RV_REG_X_FP];
+        Uns64 ra;
+        Uns64 nextFP;
+
+        while(
+            (depth<PROFILE_DEPTH)                        &&
+            fp                                           &&
+            readGuestPointer(riscv, fp-bytes,   &ra)     &&
+            readGuestPointer(riscv, fp-2*bytes, &nextFP) &&
+            ra
+        ) {
+            pc[depth++] = ra;
+
+            // frames must be strictly ascending
+            if(nextFP<=fp) {
+                break;
+            }
+
+            fp = nextFP;
+        }
+    }
+
+    return depth;
+}
+
+//
+// Sample timer callback
+//
+static VMI_ICOUNT_FN(riscvProfileSample) {
+
+    riscvP        riscv   = (riscvP)processor;
+    riscvProfileP profile = riscv->profile;
+    Uns64         pc[PROFILE_DEPTH];
+    Uns32         depth   = getStack(riscv, pc);
+
+    addSample(profile, pc, depth);
+
+    // schedule next sample
+    vmirtSetModelTimer(profile->timer, profile->interval);
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+// REPORTING
+////////////////////////////////////////////////////////////////////////////////
+
+//
+// Write formatted profile output to the given file, or the simulator log if
+// no file is given
+//
+static void profilePrintf(FILE *file, const char *format, ...) {
+
+    va_list ap;
+
+    va_start(ap, format);
+
+    if(file) {
+
+        vfprintf(file, format, ap);
+
+    } else {
+
+        char buffer[256];
+
+        vsnprintf(buffer, sizeof(buffer), format, ap);
+        vmiPrintf("%s", buffer);
+    }
+
+    va_end(ap);
+}
+
+//
+// Write the name of the function containing the given address
+//
+static void writeFrame(riscvP riscv, FILE *file, Uns64 pc) {
+
+    vmiSymbolCP symbol = vmirtSymbolByAddr((vmiProcessorP)riscv, pc);
+    const char *name   = symbol ? vmirtSymbolName(symbol) : 0;
+
+    if(name) {
+        profilePrintf(file, ";%s", name);
+    } else {
+        profilePrintf(file, ";0x"FMT_Ax, pc);
+    }
+}
+
+//
+// Write the profile in folded-stack format (one line per distinct stack with
+// frames outermost first, separated by semicolons, followed by the sample
+// count) as accepted by flame graph and pprof conversion tools
+//
+static void writeProfile(riscvP riscv, FILE *file) {
+
+    riscvProfileP profile = riscv->profile;
+    const char   *hart    = vmirtProcessorName((vmiProcessorP)riscv);
+    Uns32         i;
+
+    for(i=0; i<PROFILE_BUCKETS; i++) {
+
+        riscvProfileStackP stack;
+
+        for(stack=profile->buckets[i]; stack; stack=stack->next) {
+
+            Int32 j;
+
+            profilePrintf(file, "%s", hart);
+
+            for(j=stack->depth-1; j>=0; j--) {
+                writeFrame(riscv, file, stack->pc[j]);
+            }
+
+            profilePrintf(file, " "FMT_64u"\n", stack->count);
+        }
+    }
+}
+
+//
+// Write the profile to the configured file, or the simulator log if no file
+// is specified (each hart writes a file named with the hart name appended)
+//
+static void reportProfile(riscvP riscv) {
+
+    riscvProfileP profile = riscv->profile;
+    const char   *base    = profile->file;
+    const char   *hart    = vmirtProcessorName((vmiProcessorP)riscv);
+
+    if(base) {
+
+        char  name[strlen(base)+strlen(hart)+2];
+        FILE *file;
+
+        sprintf(name, "%s.%s", base, hart);
+
+        if(!(file=fopen(name, "w"))) {
+
+            vmiMessage("W", CPU_PREFIX "_PFO",
+                "Cannot open profile file '%s'", name
+            );
+
+        } else {
+
+            writeProfile(riscv, file);
+            fclose(file);
+
+            vmiMessage("I", CPU_PREFIX "_PFW",
+                "Profile of "FMT_64u" samples written to '%s'",
+                profile->samples, name
+            );
+        }
+
+    } else {
+
+        vmiPrintf(
+            "PROFILE (%s): "FMT_64u" samples\n",
+            hart, profile->samples
+        );
+
+        writeProfile(riscv, 0);
+    }
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+// PUBLIC INTERFACE
+////////////////////////////////////////////////////////////////////////////////
+
+//
+// Allocate sampling profiler state and start sampling if enabled
+//
+void riscvNewProfile(riscvP riscv) {
+
+    Uns32       interval = riscv->configInfo.profile_interval;
+    const char *file     = riscv->configInfo.profile_file;
+
+    if(interval) {
+
+        riscvProfileP profile = STYPE_CALLOC(riscvProfile);
+
+        profile->interval = interval;
+
+        // take a copy of the output file prefix, if any
+        if(file && file[0]) {
+            profile->file = strdup(file);
+        }
+
+        profile->timer    = vmirtCreateModelTimer(
+            (vmiProcessorP)riscv, riscvProfileSample, 1, 0
+        );
+
+        riscv->profile = profile;
+
+        // schedule first sample
+        vmirtSetModelTimer(profile->timer, interval);
+    }
+}
+
+//
+// Write sampling profile and free profiler state
+//
+void riscvFreeProfile(riscvP riscv) {
+
+    riscvProfileP profile = riscv->profile;
+
+    if(profile) {
+
+        Uns32 i;
+
+        // write profile at end of simulation
+        reportProfile(riscv);
+
+        for(i=0; i<PROFILE_BUCKETS; i++) {
+
+            riscvProfileStackP stack;
+
+            while((stack=profile->buckets[i])) {
+                profile->buckets[i] = stack->next;
+                STYPE_FREE(stack);
+            }
+        }
+
+        vmirtDeleteModelTimer(profile->timer);
+
+        if(profile->file) {
+            free(profile->file);
+        }
+
+        STYPE_FREE(profile);
+
+        riscv->profile = 0;
+    }
+}
+
+//
+// Save sampling profiler state not covered by register read/write API
+//
+void riscvProfileSave(
+    riscvP              riscv,
+    vmiSaveContextP     cxt,
+    vmiSaveRestorePhase phase
+) {
+    riscvProfileP profile = riscv->profile;
+
+    if(profile && (phase==SRT_END_CORE)) {
+        vmirtSaveModelTimer(cxt, "profileTimer", profile->timer);
+    }
+}
+
+//
+// Restore sampling profiler state not covered by register read/write API
+//
+void riscvProfileRestore(
+    riscvP              riscv,
+    vmiRestoreContextP  cxt,
+    vmiSaveRestorePhase phase
+) {
+    riscvProfileP profile = riscv->profile;
+
+    if(profile && (phase==SRT_END_CORE)) {
+        vmirtRestoreModelTimer(cxt, "profileTimer", profile->timer);
+    }
+}
+
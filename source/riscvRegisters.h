@@ -52,6 +52,7 @@
 #define RISCV_SF_FLAGS          RISCV_CPU_REG(SFMT)
 #define RISCV_JUMP_BASE         RISCV_CPU_REG(jumpBase)
 #define RISCV_PM_KEY            RISCV_CPU_REG(pmKey)
+#define RISCV_HPM_COUNT(_E)     RISCV_CPU_REG(hpmCount[_E])
 #define RISCV_VPRED_MASK        RISCV_CPU_TEMP(vFieldMask)
 #define RISCV_VACTIVE_MASK      RISCV_CPU_TEMP(vActiveMask)
 #define RISCV_VTMP              RISCV_CPU_TEMP(vTmp)
@@ -122,6 +122,71 @@ typedef struct riscvNetPortS {
     riscvNetPortP      next;
 } riscvNetPort;
 
+//
+// Extension callback events with flattened dispatch tables
+//
+typedef enum riscvExtCBEventE {
+    RVECB_TRAP,                 // trapNotifier
+    RVECB_ERET,                 // ERETNotifier
+    RVECB_RESET,                // resetNotifier
+    RVECB_EXCEPT,               // firstException
+    RVECB_PRE_MORPH,            // preMorph
+    RVECB_POST_MORPH,           // postMorph
+    RVECB_SWITCH,               // switchCB
+    RVECB_TLOAD,                // tLoad
+    RVECB_TSTORE,               // tStore
+    RVECB_PMA_CHECK,            // PMACheck
+    RVECB_LAST                  // KEEP LAST: for sizing
+} riscvExtCBEvent;
+
+//
+// Does the processor have any extension callback for the given event?
+//
+#define RISCV_HAS_EXT_CB(_P, _E) ((_P)->extCBEvents & (1<<(_E)))
+
+//
+// Iterate over the extension callback blocks implementing the given event in
+// registration order, assigning each in turn to _CB
+//
+#define RISCV_FOR_EACH_EXT_CB(_P, _E, _CB)                      \
+    for(                                                        \
+        riscvExtCBPP _table = RISCV_HAS_EXT_CB(_P, _E) ?        \
+            (_P)->extCBTable[_E] : 0;                           \
+        _table && (_CB=*_table);                                \
+        _table++                                                \
+    )
+
+//
+// Performance monitor events selectable by mhpmevent
+//
+typedef enum riscvHPMEventE {
+    RV_HPM_NONE,                // no event (counter does not increment)
+    RV_HPM_LOAD,                // load instruction
+    RV_HPM_STORE,               // store instruction
+    RV_HPM_BRANCH_TAKEN,        // taken branch or jump
+    RV_HPM_AMO,                 // atomic memory operation
+    RV_HPM_FP,                  // floating point instruction
+    RV_HPM_VECTOR,              // vector instruction
+    RV_HPM_CSR,                 // CSR access instruction
+    RV_HPM_TLB_MISS,            // TLB miss
+    RV_HPM_PTW_READ,            // page table walk read
+    RV_HPM_TRAP,                // trap taken
+    RV_HPM_LAST                 // KEEP LAST: for sizing
+} riscvHPMEvent;
+
+//
+// Mask of performance monitor events counted by JIT-translated code
+//
+#define RV_HPM_JIT_MASK ( \
+    (1<<RV_HPM_LOAD)         | \
+    (1<<RV_HPM_STORE)        | \
+    (1<<RV_HPM_BRANCH_TAKEN) | \
+    (1<<RV_HPM_AMO)          | \
+    (1<<RV_HPM_FP)           | \
+    (1<<RV_HPM_VECTOR)       | \
+    (1<<RV_HPM_CSR)            \
+)
+
 //
 // Maximum supported value of VLEN and number of vector registers (vector
 // extension)
@@ -167,8 +232,12 @@ typedef struct riscvS {
     Bool               externalActive:1;// whether external CSR access active
     Bool               inSaveRestore :1;// is save/restore active?
     Bool               useTMode      :1;// has transaction mode been enabled?
+    Bool               useStepKey    :1;// has single-step key been enabled?
     Bool               rmCheckValid  :1;// whether RM valid check required
     Bool               checkEndian   :1;// whether endian check required
+    Bool               sharedExcept  :1;// exception list owned by SMP peer
+    Bool               sharedRegInfo :1;// register views owned by SMP peer
+    Bool               sharedVIndex  :1;// vector index tables owned by peer
     Uns16              pmKey;           // polymorphic key
     Uns8               fpFlagsMT;       // flags set by JIT instructions
     Uns8               fpFlagsCSR;      // flags set by CSR write
@@ -193,6 +262,8 @@ typedef struct riscvS {
     vmiExceptionInfoCP exceptions;      // all exceptions (including extensions)
     Uns32              exceptionNum;    // number of exceptions
     Uns32              swip;            // software interrupt pending bits
+    Uns64              pendEnab;        // cached pending-and-enabled interrupts
+    Uns64              intModeMask[RISCV_MODE_LAST]; // interrupts by target mode
     Uns64              exceptionMask;   // mask of all implemented exceptions
     Uns64              interruptMask;   // mask of all implemented interrupts
     Uns32              extInt[RISCV_MODE_LAST]; // external interrupt override
@@ -207,10 +278,22 @@ typedef struct riscvS {
     // LR/SC support
     Uns64              exclusiveTag;    // tag for active exclusive access
     Uns64              exclusiveTagMask;// mask for active exclusive access
+    riscvReservationP  reservation;     // cluster reservation table entry
+    riscvP             nextHolder;      // next hart holding same reservation
+    riscvReservationP *reservations;    // reservation table (SMP root only)
+    riscvReservationP  freeReservations;// free table entries (SMP root only)
+
+    // Spin-wait loop detection
+    Uns64              spinBase;        // load base at last spin loop branch
 
     // Counter/timer support
     Uns64              baseCycles;      // base cycle count
     Uns64              baseInstructions;// base instruction count
+    Uns64              hpmCount[RV_HPM_LAST];// performance monitor event counts
+    Uns64              hpmBase[32];     // performance monitor counter bases
+    Uns64              hpmValue[32];    // performance monitor inhibited values
+    Uns8               hpmEvent[32];    // performance monitor event selectors
+    Uns32              hpmEventMask;    // mask of selected events
 
     // Debug
     vmiRegInfoP        regInfo[2];      // register views (normal and debug)
@@ -225,10 +308,17 @@ typedef struct riscvS {
     riscvNetValue      netValue;        // special net port values
     Uns32              ipDWords;        // size of ip in words
     Uns64             *ip;              // interrupt port values
+    Bool               ipDirty;         // ip changed since mip last updated
+    riscvTrapStatsP    trapStats;       // trap statistics (if enabled)
+    riscvTrapTraceP    trapTrace;       // exception trace (if enabled)
+    riscvProfileP      profile;         // sampling profiler (if enabled)
+    riscvJITStatsP     jitStats;        // JIT statistics (if enabled)
+    riscvBinaryTraceP  binaryTrace;     // binary trace (if enabled)
     Uns32              DMPortHandle;    // DM port handle (debug mode)
 
     // Timers
-    vmiModelTimerP     stepTimer;       // Debug mode single-step timer
+    vmiModelTimerP     wakeTimer;       // WFI wake-up timer
+    Bool               stepPending;     // Debug mode single-step completed
 
     // CSR support
     vmiRangeTableP     csrTable;        // per-CSR lookup table
@@ -255,6 +345,8 @@ typedef struct riscvS {
     // Enhanced model support callbacks
     riscvModelCB       cb;				// implemented by base model
     riscvExtCBP        extCBs;   		// implemented in extension
+    riscvExtCBPP       extCBTable[RVECB_LAST]; // non-null callbacks by event
+    Uns32              extCBEvents;     // events with non-null callbacks
 
     // Vector extension
     Uns8               vFieldMask;          	// vector field mask
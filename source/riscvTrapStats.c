@@ -0,0 +1,357 @@
+/*
+ * Copyright (c) 2005-2020 Imperas Software Ltd., www.imperas.com
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied.
+ *
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+// standard header files
+#include <stdio.h>
+
+// Imperas header files
+#include "hostapi/impAlloc.h"
+
+// VMI header files
+#include "vmi/vmiMessage.h"
+#include "vmi/vmiRt.h"
+
+// model header files
+#include "riscvStructure.h"
+#include "riscvTrapStats.h"
+#include "riscvUtils.h"
+
+
+////////////////////////////////////////////////////////////////////////////////
+// TRAP STATISTICS STATE
+////////////////////////////////////////////////////////////////////////////////
+
+//
+// Number of distinct causes recorded (exception codes are in the range
+// 0..0x3f and interrupts in the range 0x40..0x7f; any local interrupts beyond
+// that range are accumulated in the last slot)
+//
+#define TS_CAUSES       (riscv_E_Interrupt*2)
+
+//
+// Number of log2 buckets in each histogram (bucket 0 holds zero-cycle
+// samples, bucket N holds samples in the range [2^(N-1), 2^N) and the last
+// bucket holds all larger samples)
+//
+#define TS_BUCKETS      32
+
+//
+// This holds a histogram of cycle counts
+//
+typedef struct riscvTrapHistS {
+    Uns64 num;                  // number of samples
+    Uns64 sum;                  // total of all samples
+    Uns64 max;                  // largest sample
+    Uns64 bucket[TS_BUCKETS];   // log2 buckets
+} riscvTrapHist, *riscvTrapHistP;
+
+//
+// This holds statistics for one destination mode
+//
+typedef struct riscvTrapModeStatsS {
+    Uns64         count[TS_CAUSES];     // traps by cause
+    Uns64         latNum[TS_CAUSES];    // latency samples by cause
+    Uns64         latency[TS_CAUSES];   // total pending-to-trap cycles by cause
+    riscvTrapHist latencyHist;          // pending-to-trap histogram
+    riscvTrapHist residencyHist;        // trap-to-xRET histogram
+    Uns64         entryCycle;           // cycle count at last trap entry
+    Bool          inHandler;            // trap taken and not yet returned
+} riscvTrapModeStats, *riscvTrapModeStatsP;
+
+//
+// This holds trap statistics for a hart
+//
+typedef struct riscvTrapStatsS {
+    riscvTrapModeStats mode[RISCV_MODE_LAST];   // statistics by target mode
+    Uns64              pendingSince[64];        // cycle at which bit went high
+    Uns64              pendingValid;            // bits with valid pendingSince
+} riscvTrapStats;
+
+//
+// Return current cycle count
+//
+inline static Uns64 getCycles(riscvP riscv) {
+    return vmirtGetICount((vmiProcessorP)riscv);
+}
+
+//
+// Return statistics slot for the given exception
+//
+inline static Uns32 getCauseSlot(riscvException exception) {
+    return (exception<TS_CAUSES) ? exception : TS_CAUSES-1;
+}
+
+//
+// Add a sample to a histogram
+//
+static void addSample(riscvTrapHistP hist, Uns64 cycles) {
+
+    Uns32 bucket = cycles ? 64-__builtin_clzll(cycles) : 0;
+
+    if(bucket>=TS_BUCKETS) {
+        bucket = TS_BUCKETS-1;
+    }
+
+    hist->num++;
+    hist->sum += cycles;
+    hist->bucket[bucket]++;
+
+    if(hist->max<cycles) {
+        hist->max = cycles;
+    }
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+// REPORTING
+////////////////////////////////////////////////////////////////////////////////
+
+//
+// Return description of the cause in the given slot
+//
+static const char *getCauseName(Uns32 slot, char *buffer) {
+
+    if(slot<riscv_E_Interrupt) {
+        sprintf(buffer, "exception %u", slot);
+    } else if(slot<TS_CAUSES-1) {
+        sprintf(buffer, "interrupt %u", slot-riscv_E_Interrupt);
+    } else {
+        sprintf(buffer, "interrupt %u+", slot-riscv_E_Interrupt);
+    }
+
+    return buffer;
+}
+
+//
+// Report a histogram
+//
+static void reportHist(const char *name, riscvTrapHistP hist) {
+
+    if(hist->num) {
+
+        Uns32 i;
+
+        vmiPrintf(
+            "  %s: samples "FMT_64u" mean "FMT_64u" max "FMT_64u"\n",
+            name, hist->num, hist->sum/hist->num, hist->max
+        );
+
+        for(i=0; i<TS_BUCKETS; i++) {
+
+            if(hist->bucket[i]) {
+
+                Uns64 low  = i ? 1ULL<<(i-1) : 0;
+                Uns64 high = i ? (1ULL<<i)-1 : 0;
+
+                if(i==TS_BUCKETS-1) {
+                    vmiPrintf(
+                        "    >="FMT_64u": "FMT_64u"\n",
+                        low, hist->bucket[i]
+                    );
+                } else {
+                    vmiPrintf(
+                        "    "FMT_64u".."FMT_64u": "FMT_64u"\n",
+                        low, high, hist->bucket[i]
+                    );
+                }
+            }
+        }
+    }
+}
+
+//
+// Report trap statistics for a hart
+//
+static void reportTrapStats(riscvP riscv) {
+
+    riscvTrapStatsP stats = riscv->trapStats;
+    riscvMode       mode;
+
+    vmiPrintf(
+        "TRAP STATISTICS (%s):\n", vmirtProcessorName((vmiProcessorP)riscv)
+    );
+
+    for(mode=0; mode<RISCV_MODE_LAST; mode++) {
+
+        riscvTrapModeStatsP this  = &stats->mode[mode];
+        Uns64               total = 0;
+        Uns32               slot;
+
+        for(slot=0; slot<TS_CAUSES; slot++) {
+            total += this->count[slot];
+        }
+
+        if(total) {
+
+            vmiPrintf(
+                "%s mode: "FMT_64u" traps\n", riscvGetModeName(mode), total
+            );
+
+            for(slot=0; slot<TS_CAUSES; slot++) {
+
+                Uns64 count = this->count[slot];
+
+                if(count) {
+
+                    char buffer[32];
+
+                    vmiPrintf(
+                        "  %-16s count "FMT_64u,
+                        getCauseName(slot, buffer), count
+                    );
+
+                    if(this->latNum[slot]) {
+                        vmiPrintf(
+                            " mean latency "FMT_64u,
+                            this->latency[slot]/this->latNum[slot]
+                        );
+                    }
+
+                    vmiPrintf("\n");
+                }
+            }
+
+            reportHist("interrupt latency", &this->latencyHist);
+            reportHist("handler residency", &this->residencyHist);
+        }
+    }
+}
+
+//
+// Report trap statistics
+//
+static VMIRT_COMMAND_PARSE_FN(trapStatsCommand) {
+
+    riscvP riscv = (riscvP)processor;
+
+    reportTrapStats(riscv);
+
+    return "1";
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+// PUBLIC INTERFACE
+////////////////////////////////////////////////////////////////////////////////
+
+//
+// Allocate trap statistics state if enabled
+//
+void riscvNewTrapStats(riscvP riscv) {
+
+    if(riscv->configInfo.trap_stats) {
+
+        riscv->trapStats = STYPE_CALLOC(riscvTrapStats);
+
+        // trapStats command
+        vmirtAddCommandParse(
+            (vmiProcessorP)riscv,
+            "trapStats",
+            "show trap counts, interrupt latency and handler residency",
+            trapStatsCommand,
+            VMI_CT_QUERY|VMI_CO_CPU|VMI_CA_REPORT
+        );
+    }
+}
+
+//
+// Report and free trap statistics state
+//
+void riscvFreeTrapStats(riscvP riscv) {
+
+    if(riscv->trapStats) {
+
+        // report statistics at end of simulation
+        reportTrapStats(riscv);
+
+        STYPE_FREE(riscv->trapStats);
+        riscv->trapStats = 0;
+    }
+}
+
+//
+// Record interrupt pending state change from oldIP to newIP
+//
+void riscvTrapStatsPending(riscvP riscv, Uns64 oldIP, Uns64 newIP) {
+
+    riscvTrapStatsP stats  = riscv->trapStats;
+    Uns64           rising = newIP & ~oldIP;
+    Uns64           now    = getCycles(riscv);
+
+    // interrupts no longer pending have no valid start time
+    stats->pendingValid &= newIP;
+
+    // record the start time of each newly-pending interrupt
+    while(rising) {
+
+        Uns32 i = __builtin_ctzll(rising);
+
+        stats->pendingSince[i] = now;
+        stats->pendingValid   |= (1ULL<<i);
+        rising                &= rising-1;
+    }
+}
+
+//
+// Record trap entry to the given mode
+//
+void riscvTrapStatsTrap(riscvP riscv, riscvException exception, riscvMode mode) {
+
+    riscvTrapStatsP     stats = riscv->trapStats;
+    riscvTrapModeStatsP this  = &stats->mode[mode];
+    Uns32               slot  = getCauseSlot(exception);
+    Uns64               now   = getCycles(riscv);
+
+    this->count[slot]++;
+    this->entryCycle = now;
+    this->inHandler  = True;
+
+    // record latency from interrupt pending to trap entry
+    if(exception>=riscv_E_Interrupt) {
+
+        Uns32 i    = exception-riscv_E_Interrupt;
+        Uns64 mask = (i<64) ? (1ULL<<i) : 0;
+
+        if(stats->pendingValid & mask) {
+
+            Uns64 latency = now-stats->pendingSince[i];
+
+            this->latNum[slot]++;
+            this->latency[slot] += latency;
+            addSample(&this->latencyHist, latency);
+
+            // count latency once for each pending edge
+            stats->pendingValid &= ~mask;
+        }
+    }
+}
+
+//
+// Record return from trap taken to the given mode
+//
+void riscvTrapStatsReturn(riscvP riscv, riscvMode mode) {
+
+    riscvTrapModeStatsP this = &riscv->trapStats->mode[mode];
+
+    if(this->inHandler) {
+        addSample(&this->residencyHist, getCycles(riscv)-this->entryCycle);
+        this->inHandler = False;
+    }
+}
+
@@ -0,0 +1,54 @@
+/*
+ * Copyright (c) 2005-2020 Imperas Software Ltd., www.imperas.com
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied.
+ *
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#pragma once
+
+// VMI header files
+#include "vmi/vmiTypes.h"
+
+// model header files
+#include "riscvExceptionTypes.h"
+#include "riscvMode.h"
+#include "riscvTypeRefs.h"
+
+//
+// Allocate trap statistics state if enabled
+//
+void riscvNewTrapStats(riscvP riscv);
+
+//
+// Report and free trap statistics state
+//
+void riscvFreeTrapStats(riscvP riscv);
+
+//
+// Record interrupt pending state change from oldIP to newIP
+//
+void riscvTrapStatsPending(riscvP riscv, Uns64 oldIP, Uns64 newIP);
+
+//
+// Record trap entry to the given mode
+//
+void riscvTrapStatsTrap(riscvP riscv, riscvException exception, riscvMode mode);
+
+//
+// Record return from trap taken to the given mode
+//
+void riscvTrapStatsReturn(riscvP riscv, riscvMode mode);
+
@@ -0,0 +1,272 @@
+/*
+ * Copyright (c) 2005-2020 Imperas Software Ltd., www.imperas.com
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied.
+ *
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+// Standard header files
+#include <stdio.h>
+
+// Imperas header files
+#include "hostapi/impAlloc.h"
+
+// VMI header files
+#include "vmi/vmiMessage.h"
+#include "vmi/vmiRt.h"
+
+// model header files
+#include "riscvExceptions.h"
+#include "riscvMessage.h"
+#include "riscvStructure.h"
+#include "riscvTrapTrace.h"
+#include "riscvUtils.h"
+
+
+////////////////////////////////////////////////////////////////////////////////
+// EXCEPTION TRACE STATE
+////////////////////////////////////////////////////////////////////////////////
+
+//
+// This holds one exception trace record
+//
+typedef struct riscvTrapRecordS {
+    Uns64          cycle;       // cycle count at trap entry
+    Uns64          EPC;         // exception program counter
+    Uns64          tval;        // trap value
+    Uns64          handlerPC;   // handler address
+    riscvException exception;   // exception code
+    Uns8           modeY;       // source mode
+    Uns8           modeX;       // destination mode
+} riscvTrapRecord, *riscvTrapRecordP;
+
+//
+// This holds the exception trace ring buffer for a hart
+//
+typedef struct riscvTrapTraceS {
+    riscvTrapRecordP records;   // ring buffer
+    Uns32            num;       // number of entries in ring buffer
+    Uns32            next;      // index of next entry to write
+    Uns64            total;     // total number of records written
+    Bool             dumped;    // whether trap loop dump has been done
+} riscvTrapTrace;
+
+
+////////////////////////////////////////////////////////////////////////////////
+// DUMPING
+////////////////////////////////////////////////////////////////////////////////
+
+//
+// Return description of the given exception, including exceptions defined by
+// a derived model
+//
+static const char *getTrapDesc(
+    riscvP         riscv,
+    riscvException exception,
+    char          *buffer
+) {
+    const char        *result = riscvGetExceptionDesc(exception, buffer);
+    vmiExceptionInfoCP info   = riscv->exceptions;
+
+    // search all exceptions if not a base model exception
+    while(!result && info && info->name) {
+        if(info->code==exception) {
+            result = info->description ? info->description : info->name;
+        }
+        info++;
+    }
+
+    // use exception code if no description is found
+    if(!result) {
+        sprintf(buffer, "Exception %u", exception);
+        result = buffer;
+    }
+
+    return result;
+}
+
+//
+// Dump one exception trace record
+//
+static void dumpRecord(riscvP riscv, riscvTrapRecordP record) {
+
+    char buffer[32];
+
+    vmiPrintf(
+        "  "FMT_64u": %s (%u) %s->%s EPC 0x"FMT_6408x" tval 0x"FMT_6408x
+        " handler 0x"FMT_6408x"\n",
+        record->cycle,
+        getTrapDesc(riscv, record->exception, buffer),
+        record->exception,
+        riscvGetModeName(record->modeY),
+        riscvGetModeName(record->modeX),
+        record->EPC,
+        record->tval,
+        record->handlerPC
+    );
+}
+
+//
+// Dump the contents of the exception trace ring buffer, oldest first
+//
+void riscvTrapTraceDump(riscvP riscv) {
+
+    riscvTrapTraceP trace = riscv->trapTrace;
+
+    if(trace) {
+
+        Uns32 num   = (trace->total<trace->num) ? trace->total : trace->num;
+        Uns32 index = (trace->next+trace->num-num) % trace->num;
+        Uns32 i;
+
+        vmiPrintf(
+            "EXCEPTION TRACE (%s): last %u of "FMT_64u" traps\n",
+            vmirtProcessorName((vmiProcessorP)riscv), num, trace->total
+        );
+
+        for(i=0; i<num; i++) {
+            dumpRecord(riscv, &trace->records[index]);
+            index = (index+1==trace->num) ? 0 : index+1;
+        }
+    }
+}
+
+//
+// Dump the exception trace
+//
+static VMIRT_COMMAND_PARSE_FN(exceptionTraceCommand) {
+
+    riscvP riscv = (riscvP)processor;
+
+    riscvTrapTraceDump(riscv);
+
+    return "1";
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+// PUBLIC INTERFACE
+////////////////////////////////////////////////////////////////////////////////
+
+//
+// Allocate exception trace ring buffer if enabled
+//
+void riscvNewTrapTrace(riscvP riscv) {
+
+    Uns32 num = riscv->configInfo.exception_trace;
+
+    if(num) {
+
+        riscvTrapTraceP trace = STYPE_CALLOC(riscvTrapTrace);
+
+        trace->records = STYPE_CALLOC_N(riscvTrapRecord, num);
+        trace->num     = num;
+
+        riscv->trapTrace = trace;
+
+        // exceptionTrace command
+        vmirtAddCommandParse(
+            (vmiProcessorP)riscv,
+            "exceptionTrace",
+            "show most recent exceptions and interrupts",
+            exceptionTraceCommand,
+            VMI_CT_QUERY|VMI_CO_CPU|VMI_CA_REPORT
+        );
+    }
+}
+
+//
+// Free exception trace ring buffer
+//
+void riscvFreeTrapTrace(riscvP riscv) {
+
+    riscvTrapTraceP trace = riscv->trapTrace;
+
+    if(trace) {
+
+        STYPE_FREE(trace->records);
+        STYPE_FREE(trace);
+
+        riscv->trapTrace = 0;
+    }
+}
+
+//
+// Is the new trap a synchronous exception taken at the handler of an
+// identical previous trap? This indicates a trap loop that will not make
+// forward progress.
+//
+static Bool isTrapLoop(
+    riscvTrapTraceP  trace,
+    riscvTrapRecordP record,
+    riscvTrapRecordP previous
+) {
+    return (
+        trace->total &&
+        (record->exception<riscv_E_Interrupt) &&
+        (record->exception==previous->exception) &&
+        (record->modeX==previous->modeX) &&
+        (record->EPC==previous->handlerPC)
+    );
+}
+
+//
+// Record a trap in the exception trace ring buffer
+//
+void riscvTrapTraceAdd(
+    riscvP         riscv,
+    riscvException exception,
+    Uns64          tval,
+    Uns64          EPC,
+    Uns64          handlerPC,
+    riscvMode      modeY,
+    riscvMode      modeX
+) {
+    riscvTrapTraceP  trace    = riscv->trapTrace;
+    Uns32            prev     = trace->next ? trace->next-1 : trace->num-1;
+    riscvTrapRecord  previous = trace->records[prev];
+    riscvTrapRecordP record   = &trace->records[trace->next];
+    Bool             loop;
+
+    // fill the record
+    record->cycle     = vmirtGetICount((vmiProcessorP)riscv);
+    record->EPC       = EPC;
+    record->tval      = tval;
+    record->handlerPC = handlerPC;
+    record->exception = exception;
+    record->modeY     = modeY;
+    record->modeX     = modeX;
+
+    // detect trap loop before advancing the ring buffer
+    loop = isTrapLoop(trace, record, &previous);
+
+    // advance the ring buffer
+    trace->next = (trace->next+1==trace->num) ? 0 : trace->next+1;
+    trace->total++;
+
+    // dump the trace the first time a trap loop is detected
+    if(loop && !trace->dumped) {
+
+        trace->dumped = True;
+
+        vmiMessage("W", CPU_PREFIX "_TLP",
+            "Trap loop detected at 0x"FMT_Ax" - dumping exception trace",
+            EPC
+        );
+
+        riscvTrapTraceDump(riscv);
+    }
+}
+
@@ -0,0 +1,57 @@
+/*
+ * Copyright (c) 2005-2020 Imperas Software Ltd., www.imperas.com
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied.
+ *
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#pragma once
+
+// VMI header files
+#include "vmi/vmiTypes.h"
+
+// model header files
+#include "riscvExceptionTypes.h"
+#include "riscvMode.h"
+#include "riscvTypeRefs.h"
+
+//
+// Allocate exception trace ring buffer if enabled
+//
+void riscvNewTrapTrace(riscvP riscv);
+
+//
+// Free exception trace ring buffer
+//
+void riscvFreeTrapTrace(riscvP riscv);
+
+//
+// Record a trap in the exception trace ring buffer
+//
+void riscvTrapTraceAdd(
+    riscvP         riscv,
+    riscvException exception,
+    Uns64          tval,
+    Uns64          EPC,
+    Uns64          handlerPC,
+    riscvMode      modeY,
+    riscvMode      modeX
+);
+
+//
+// Dump the contents of the exception trace ring buffer, oldest first
+//
+void riscvTrapTraceDump(riscvP riscv);
+
@@ -23,6 +23,7 @@
 #include "hostapi/typeMacros.h"
 
 DEFINE_S (riscv);
+DEFINE_S (riscvBinaryTrace);
 DEFINE_S (riscvBlockState);
 DEFINE_S (riscvBusPort);
 DEFINE_S (riscvConfig);
@@ -33,9 +34,14 @@ DEFINE_CS(riscvExceptionDesc);
 DEFINE_S (riscvExtCB);
 DEFINE_CS(riscvExtConfig);
 DEFINE_S (riscvInstrInfo);
+DEFINE_S (riscvJITStats);
 DEFINE_S (riscvNetPort);
 DEFINE_CS(riscvMorphAttr);
 DEFINE_S (riscvMorphState);
 DEFINE_S (riscvParamValues);
+DEFINE_S (riscvProfile);
+DEFINE_S (riscvReservation);
 DEFINE_S (riscvTLB);
+DEFINE_S (riscvTrapTrace);
+DEFINE_S (riscvTrapStats);
 
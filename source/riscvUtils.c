@@ -17,6 +17,9 @@
  *
  */
 
+// Imperas header files
+#include "hostapi/impAlloc.h"
+
 // VMI header files
 #include "vmi/vmiCxt.h"
 #include "vmi/vmiMessage.h"
@@ -25,9 +28,11 @@
 
 // model header files
 #include "riscvBlockState.h"
+#include "riscvCluster.h"
 #include "riscvDecode.h"
 #include "riscvExceptions.h"
 #include "riscvFunctions.h"
+#include "riscvJITStats.h"
 #include "riscvMessage.h"
 #include "riscvMode.h"
 #include "riscvStructure.h"
@@ -131,7 +136,84 @@ Uns32 riscvGetFlenArch(riscvP riscv) {
 }
 
 //
-// Register extension callback block for the id with the base model
+// Does the extension callback block implement the given event?
+//
+static Bool hasExtCBEvent(riscvExtCBP extCB, riscvExtCBEvent event) {
+
+    switch(event) {
+        case RVECB_TRAP:       return extCB->trapNotifier   != 0;
+        case RVECB_ERET:       return extCB->ERETNotifier   != 0;
+        case RVECB_RESET:      return extCB->resetNotifier  != 0;
+        case RVECB_EXCEPT:     return extCB->firstException != 0;
+        case RVECB_PRE_MORPH:  return extCB->preMorph       != 0;
+        case RVECB_POST_MORPH: return extCB->postMorph      != 0;
+        case RVECB_SWITCH:     return extCB->switchCB       != 0;
+        case RVECB_TLOAD:      return extCB->tLoad          != 0;
+        case RVECB_TSTORE:     return extCB->tStore         != 0;
+        case RVECB_PMA_CHECK:  return extCB->PMACheck       != 0;
+        default:               return False;
+    }
+}
+
+//
+// Free flattened extension callback dispatch tables
+//
+void riscvFreeExtCBTables(riscvP riscv) {
+
+    riscvExtCBEvent event;
+
+    for(event=0; event<RVECB_LAST; event++) {
+
+        if(riscv->extCBTable[event]) {
+            STYPE_FREE(riscv->extCBTable[event]);
+            riscv->extCBTable[event] = 0;
+        }
+    }
+
+    riscv->extCBEvents = 0;
+}
+
+//
+// Rebuild flattened extension callback dispatch tables: for each event, this
+// is a null-terminated array of the extension callback blocks implementing it
+// in registration order, so that dispatch on hot paths (translation, trap
+// entry) does not need to walk the list or test each function pointer
+//
+static void refreshExtCBTables(riscvP riscv) {
+
+    riscvExtCBEvent event;
+
+    riscvFreeExtCBTables(riscv);
+
+    for(event=0; event<RVECB_LAST; event++) {
+
+        riscvExtCBP extCB;
+        Uns32       num = 0;
+
+        for(extCB=riscv->extCBs; extCB; extCB=extCB->next) {
+            num += hasExtCBEvent(extCB, event);
+        }
+
+        if(num) {
+
+            riscvExtCBPP table = STYPE_CALLOC_N(riscvExtCBP, num+1);
+            Uns32        i     = 0;
+
+            for(extCB=riscv->extCBs; extCB; extCB=extCB->next) {
+                if(hasExtCBEvent(extCB, event)) {
+                    table[i++] = extCB;
+                }
+            }
+
+            riscv->extCBTable[event] = table;
+            riscv->extCBEvents      |= (1<<event);
+        }
+    }
+}
+
+//
+// Register extension callback block for the id with the base model (all
+// callbacks in the block must be filled before registration)
 //
 void riscvRegisterExtCB(riscvP riscv, riscvExtCBP extCB, Uns32 id) {
 
@@ -145,6 +227,8 @@ void riscvRegisterExtCB(riscvP riscv, riscvExtCBP extCB, Uns32 id) {
     *tail = extCB;
     extCB->next = 0;
     extCB->id   = id;
+
+    refreshExtCBTables(riscv);
 }
 
 //
@@ -350,6 +434,9 @@ void riscvSetMode(riscvP riscv, riscvMode mode) {
 
     // set step breakpoint if required
     riscvSetStepBreakpoint(riscv);
+
+    // interrupt enables depend on current mode
+    riscvRefreshPendingAndEnabled(riscv);
 }
 
 //
@@ -650,28 +737,188 @@ riscvArchitecture riscvParseExtensions(const char *extensions) {
 ////////////////////////////////////////////////////////////////////////////////
 
 //
-// If this memory access callback is triggered, abort any active load linked
+// Number of buckets in the cluster LR/SC reservation table (power of two)
+//
+#define RESERVATION_BUCKETS_LOG2 6
+#define RESERVATION_BUCKETS      (1<<RESERVATION_BUCKETS_LOG2)
+
+//
+// Entry in the cluster LR/SC reservation table, describing one watched granule
+// and the harts holding a reservation on it. A single memory watch callback is
+// shared by all holders. A hart is added when it suspends with a reservation
+// and stays in the entry while it runs, so a hart repeatedly reserving the
+// same granule does not add and remove watchpoints on every context switch.
+// LR, SC and reset update the exclusive tag without reference to the table,
+// so a holder whose tag no longer matches its entry is stale and is removed
+// lazily.
+//
+typedef struct riscvReservationS {
+    riscvReservationP next;         // next entry in the same bucket
+    riscvP            holders;      // harts holding reservation on granule
+    memDomainP        domain;       // watched data domain
+    Uns64             tag;          // granule tag
+    Uns64             tagMask;      // granule tag mask
+} riscvReservation;
+
+static void removeReservation(riscvP riscv);
+
+//
+// Is the hart's current exclusive access to the granule of the given entry?
+//
+inline static Bool isActiveHolder(riscvP riscv, riscvReservationP entry) {
+    return (
+        (riscv->exclusiveTag==entry->tag) &&
+        (riscv->exclusiveTagMask==entry->tagMask)
+    );
+}
+
+//
+// If this memory access callback is triggered, abort the exclusive access of
+// every other hart holding a reservation on the granule (stores by a hart
+// to its own reservation granule do not abort its exclusive access)
 //
 static VMI_MEM_WATCH_FN(abortEA) {
+
     if(processor) {
-        riscvAbortExclusiveAccess((riscvP)userData);
+
+        riscvReservationP entry = userData;
+        riscvP            store = (riscvP)processor;
+        riscvP            holder;
+
+        // the entry is released when its last holder is removed, so the next
+        // holder must be read before each removal
+        for(holder=entry->holders; holder; ) {
+
+            riscvP next   = holder->nextHolder;
+            Bool   active = isActiveHolder(holder, entry);
+
+            if(!active) {
+
+                // remove stale holder
+                removeReservation(holder);
+
+            } else if(holder!=store) {
+
+                // abort exclusive access of another hart
+                removeReservation(holder);
+                holder->exclusiveTag = RISCV_NO_TAG;
+            }
+
+            holder = next;
+        }
     }
 }
 
 //
-// Install or remove the exclusive access monitor callback
+// Return the reservation table bucket for the given tag
 //
-static void updateExclusiveAccessCallback(riscvP riscv, Bool install) {
+static riscvReservationP *getReservationBucket(riscvP root, Uns64 tag) {
 
-    memDomainP domain  = vmirtGetProcessorDataDomain((vmiProcessorP)riscv);
-    Uns64      simLow  = riscv->exclusiveTag;
-    Uns64      simHigh = simLow + ~riscv->exclusiveTagMask;
+    // allocate table on first use
+    if(!root->reservations) {
+        root->reservations = STYPE_CALLOC_N(
+            riscvReservationP, RESERVATION_BUCKETS
+        );
+    }
 
-    // install or remove a watchpoint on the current exclusive access address
-    if(install) {
-        vmirtAddWriteCallback(domain, 0, simLow, simHigh, abortEA, riscv);
-    } else {
-        vmirtRemoveWriteCallback(domain, 0, simLow, simHigh, abortEA, riscv);
+    Uns32 index = (tag*0x9e3779b97f4a7c15ULL) >> (64-RESERVATION_BUCKETS_LOG2);
+
+    return &root->reservations[index];
+}
+
+//
+// Add the hart to the reservation table entry for its exclusive access
+// granule, creating the entry and its watch callback if required
+//
+static void addReservation(riscvP riscv) {
+
+    vmiProcessorP      processor = (vmiProcessorP)riscv;
+    riscvP             root      = riscv->smpRoot;
+    memDomainP         domain    = vmirtGetProcessorDataDomain(processor);
+    Uns64              tag       = riscv->exclusiveTag;
+    Uns64              tagMask   = riscv->exclusiveTagMask;
+    riscvReservationP *bucket    = getReservationBucket(root, tag);
+    riscvReservationP  entry     = *bucket;
+
+    // find any existing entry for this granule
+    while(
+        entry && (
+            (entry->tag!=tag)         ||
+            (entry->tagMask!=tagMask) ||
+            (entry->domain!=domain)
+        )
+    ) {
+        entry = entry->next;
+    }
+
+    if(!entry) {
+
+        // reuse a free entry if possible
+        if((entry=root->freeReservations)) {
+            root->freeReservations = entry->next;
+        } else {
+            entry = STYPE_CALLOC(riscvReservation);
+        }
+
+        entry->holders = 0;
+        entry->domain  = domain;
+        entry->tag     = tag;
+        entry->tagMask = tagMask;
+        entry->next    = *bucket;
+        *bucket        = entry;
+
+        // install a watchpoint on the granule
+        vmirtAddWriteCallback(domain, 0, tag, tag+~tagMask, abortEA, entry);
+    }
+
+    // add this hart to the holders of the entry
+    riscv->reservation = entry;
+    riscv->nextHolder  = entry->holders;
+    entry->holders     = riscv;
+}
+
+//
+// Remove the hart from any reservation table entry, releasing the entry and
+// its watch callback when the last holder is removed
+//
+static void removeReservation(riscvP riscv) {
+
+    riscvReservationP entry = riscv->reservation;
+
+    if(entry) {
+
+        riscvP  root = riscv->smpRoot;
+        riscvP *prevP;
+
+        // remove this hart from the holders of the entry
+        for(prevP=&entry->holders; *prevP!=riscv; prevP=&(*prevP)->nextHolder) {
+            // no action
+        }
+
+        *prevP = riscv->nextHolder;
+
+        riscv->reservation = 0;
+        riscv->nextHolder  = 0;
+
+        if(!entry->holders) {
+
+            riscvReservationP *bucket = getReservationBucket(root, entry->tag);
+            Uns64              tag    = entry->tag;
+
+            // remove the watchpoint on the granule
+            vmirtRemoveWriteCallback(
+                entry->domain, 0, tag, tag+~entry->tagMask, abortEA, entry
+            );
+
+            // unlink the entry from its bucket and add it to the free list
+            for(; *bucket!=entry; bucket=&(*bucket)->next) {
+                // no action
+            }
+
+            *bucket                = entry->next;
+            entry->next            = root->freeReservations;
+            root->freeReservations = entry;
+        }
     }
 }
 
@@ -680,22 +927,63 @@ static void updateExclusiveAccessCallback(riscvP riscv, Bool install) {
 //
 void riscvAbortExclusiveAccess(riscvP riscv) {
 
-    if(riscv->exclusiveTag != RISCV_NO_TAG) {
+    // remove any reservation table entry (BEFORE clearing exclusive tag)
+    removeReservation(riscv);
 
-        // remove callback on exclusive access monitor region
-        updateExclusiveAccessCallback(riscv, False);
+    // clear exclusive tag
+    riscv->exclusiveTag = RISCV_NO_TAG;
+}
 
-        // clear exclusive tag (AFTER updateExclusiveAccessCallback)
-        riscv->exclusiveTag = RISCV_NO_TAG;
+//
+// Add to or remove from the cluster reservation table if required. When
+// installing, an existing entry is retained if it still describes the current
+// exclusive access of the hart.
+//
+void riscvUpdateExclusiveAccessCallback(riscvP riscv, Bool install) {
+
+    riscvReservationP entry = riscv->reservation;
+
+    if(!install) {
+
+        removeReservation(riscv);
+
+    } else if(
+        !entry ||
+        !isActiveHolder(riscv, entry) ||
+        (entry->domain!=vmirtGetProcessorDataDomain((vmiProcessorP)riscv))
+    ) {
+        removeReservation(riscv);
+
+        if(riscv->exclusiveTag != RISCV_NO_TAG) {
+            addReservation(riscv);
+        }
     }
 }
 
 //
-// Install or remove the exclusive access monitor callback if required
+// Free the cluster reservation table
 //
-void riscvUpdateExclusiveAccessCallback(riscvP riscv, Bool install) {
-    if(riscv->exclusiveTag != RISCV_NO_TAG) {
-        updateExclusiveAccessCallback(riscv, install);
+void riscvFreeReservations(riscvP riscv) {
+
+    riscvReservationP entry;
+
+    if(riscv->reservations) {
+
+        Uns32 i;
+
+        for(i=0; i<RESERVATION_BUCKETS; i++) {
+            while((entry=riscv->reservations[i])) {
+                riscv->reservations[i] = entry->next;
+                STYPE_FREE(entry);
+            }
+        }
+
+        STYPE_FREE(riscv->reservations);
+    }
+
+    while((entry=riscv->freeReservations)) {
+        riscv->freeReservations = entry->next;
+        STYPE_FREE(entry);
     }
 }
 
@@ -708,14 +996,60 @@ VMI_IASSWITCH_FN(riscvContextSwitchCB) {
     riscvP      riscv = (riscvP)processor;
     riscvExtCBP extCB;
 
-    riscvUpdateExclusiveAccessCallback(riscv, state==RS_SUSPEND);
+    // register any active reservation when suspending (the reservation is
+    // retained while the hart runs)
+    if(state==RS_SUSPEND) {
+        riscvUpdateExclusiveAccessCallback(riscv, True);
+    }
 
     // call derived model context switch function if required
-    for(extCB=riscv->extCBs; extCB; extCB=extCB->next) {
-        if(extCB->switchCB) {
-            extCB->switchCB(riscv, state, extCB->clientData);
-        }
+    RISCV_FOR_EACH_EXT_CB(riscv, RVECB_SWITCH, extCB) {
+        extCB->switchCB(riscv, state, extCB->clientData);
+    }
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+// SHARED CONFIGURATION TABLES
+////////////////////////////////////////////////////////////////////////////////
+
+//
+// Return the hart from which the passed hart may share read-only tables
+// derived from its configuration, or NULL if there is no such hart. All harts
+// in an SMP container are constructed from the same parameters, so tables
+// built by the first hart may be shared by the others; each table owner must
+// still check that any configuration on which the table depends matches, and
+// build a private table if not. Members of AMP clusters have distinct
+// configurations and never share tables.
+//
+riscvP riscvGetSMPPrototype(riscvP riscv) {
+
+    riscvP parent    = riscv->parent;
+    riscvP prototype = 0;
+
+    if(parent && !riscvIsCluster(parent)) {
+        prototype = (riscvP)vmirtGetSMPChild((vmiProcessorP)parent);
     }
+
+    return (prototype!=riscv) ? prototype : 0;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+// TRANSLATION CACHE
+////////////////////////////////////////////////////////////////////////////////
+
+//
+// Discard all translated code for this processor
+//
+void riscvFlushAllDicts(riscvP riscv) {
+
+    // record flush in JIT statistics if required
+    if(riscv->jitStats) {
+        riscvJITStatsFlush(riscv);
+    }
+
+    vmirtFlushAllDicts((vmiProcessorP)riscv);
 }
 
 
@@ -733,7 +1067,7 @@ RISCV_SET_TMODE_FN(riscvSetTMode) {
 
         riscv->useTMode = True;
 
-        vmirtFlushAllDicts((vmiProcessorP)riscv);
+        riscvFlushAllDicts(riscv);
     }
 
     // enable mode using polymorphic key
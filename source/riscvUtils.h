@@ -72,6 +72,11 @@ memEndian riscvGetCurrentDataEndian(riscvP riscv);
 //
 void riscvRegisterExtCB(riscvP riscv, riscvExtCBP extCB, Uns32 id);
 
+//
+// Free flattened extension callback dispatch tables
+//
+void riscvFreeExtCBTables(riscvP riscv);
+
 //
 // Return the indexed extension's extCB clientData
 //
@@ -145,10 +150,26 @@ riscvArchitecture riscvParseExtensions(const char *extensions);
 void riscvAbortExclusiveAccess(riscvP riscv);
 
 //
-// Install or remove the exclusive access monitor callback if required
+// Add to or remove from the cluster reservation table if required
 //
 void riscvUpdateExclusiveAccessCallback(riscvP riscv, Bool install);
 
+//
+// Free the cluster reservation table
+//
+void riscvFreeReservations(riscvP riscv);
+
+//
+// Return the hart from which the passed hart may share read-only tables
+// derived from its configuration, or NULL if there is no such hart
+//
+riscvP riscvGetSMPPrototype(riscvP riscv);
+
+//
+// Discard all translated code for this processor
+//
+void riscvFlushAllDicts(riscvP riscv);
+
 //
 // Enable or disable transaction mode
 //
@@ -406,6 +406,11 @@ static Uns64 readPageTableEntry(
     memEndian endian = riscvGetDataEndian(riscv, RISCV_MODE_SUPERVISOR);
     Uns64     result;
 
+    // count page table walk read event unless an artifact access
+    if(!MEM_AA_IS_ARTIFACT_ACCESS(attrs)) {
+        riscv->hpmCount[RV_HPM_PTW_READ]++;
+    }
+
     // enter PTW context
     riscv->PTWActive  = True;
     riscv->PTWBadAddr = False;
@@ -1692,6 +1697,37 @@ static VMIRT_COMMAND_PARSE_FN(dumpTLBCommand) {
     return "1";
 }
 
+//
+// Report TLB statistics (TLB misses and page table walk reads, excluding
+// artifact accesses)
+//
+static void reportTLBStats(riscvP riscv) {
+
+    vmiPrintf(
+        "TLB STATISTICS (%s):\n", vmirtProcessorName((vmiProcessorP)riscv)
+    );
+    vmiPrintf(
+        "  misses:                "FMT_64u"\n",
+        riscv->hpmCount[RV_HPM_TLB_MISS]
+    );
+    vmiPrintf(
+        "  page table walk reads: "FMT_64u"\n",
+        riscv->hpmCount[RV_HPM_PTW_READ]
+    );
+}
+
+//
+// Report TLB statistics
+//
+static VMIRT_COMMAND_PARSE_FN(tlbStatsCommand) {
+
+    riscvP riscv = (riscvP)processor;
+
+    reportTLBStats(riscv);
+
+    return "1";
+}
+
 //
 // Virtual memory initialization
 //
@@ -1787,6 +1823,17 @@ VMI_VMINIT_FN(riscvVMInit) {
             dumpTLBCommand,
             VMI_CT_QUERY|VMI_CO_TLB|VMI_CA_QUERY
         );
+
+        // tlbStats command
+        if(riscv->configInfo.tlb_stats) {
+            vmirtAddCommandParse(
+                processor,
+                "tlbStats",
+                "show TLB miss and page table walk counts",
+                tlbStatsCommand,
+                VMI_CT_QUERY|VMI_CO_TLB|VMI_CA_REPORT
+            );
+        }
     }
 }
 
@@ -2499,13 +2546,11 @@ static void mapPMA(
 ) {
     riscvExtCBP extCB;
 
-    // call derived model transaction store functions
-    for(extCB=riscv->extCBs; extCB; extCB=extCB->next) {
-        if(extCB->PMACheck) {
-            extCB->PMACheck(
-                riscv, mode, requiredPriv, lowPA, highPA, extCB->clientData
-            );
-        }
+    // call derived model PMA check functions
+    RISCV_FOR_EACH_EXT_CB(riscv, RVECB_PMA_CHECK, extCB) {
+        extCB->PMACheck(
+            riscv, mode, requiredPriv, lowPA, highPA, extCB->clientData
+        );
     }
 }
 
@@ -2674,6 +2719,11 @@ Bool riscvVMMiss(
                 Uns64      lastVA = address+bytes-1;
                 tlbMapInfo mi     = {lowVA:address, highVA:address-1};
 
+                // count TLB miss event unless an artifact access
+                if(!MEM_AA_IS_ARTIFACT_ACCESS(attrs)) {
+                    riscv->hpmCount[RV_HPM_TLB_MISS]++;
+                }
+
                 // iterate while unprocessed regions remain
                 do {
 
@@ -2709,6 +2759,12 @@ Bool riscvVMMiss(
 // Free structures used for virtual memory management
 //
 void riscvVMFree(riscvP riscv) {
+
+    // report TLB statistics at end of simulation
+    if(riscv->tlb && riscv->configInfo.tlb_stats) {
+        reportTLBStats(riscv);
+    }
+
     freeTLB(riscv, riscv->tlb);
 }
 
@@ -2831,25 +2887,27 @@ void riscvVMRefreshMPRVDomain(riscvP riscv) {
 // TLB SAVE/RESTORE SUPPORT
 ////////////////////////////////////////////////////////////////////////////////
 
-#define RISCV_TLB_ENTRY "TLB_ENTRY"
-#define RISCV_TLB_END   "TLB_END"
+#define RISCV_TLB_HEADER  "TLB_HEADER"
+#define RISCV_TLB_ENTRIES "TLB_ENTRIES"
+
+// element names used by checkpoints saved by previous versions of the model
+#define RISCV_TLB_ENTRY   "TLB_ENTRY"
+#define RISCV_TLB_END     "TLB_END"
 
 //
-// Save contents of one TLB entry
+// Version of the saved TLB image (increment when tlbEntry layout changes)
 //
-static void saveTLBEntry(vmiSaveContextP cxt, tlbEntryP entry) {
+#define RISCV_TLB_VERSION 1
 
-    // save entry
-    tlbEntry entryS = *entry;
-
-    // clear down properties used to manage mapping
-    entryS.isMapped = 0;
-    entryS.lutEntry = 0;
-
-    vmirtSaveElement(
-        cxt, RISCV_TLB_ENTRY, RISCV_TLB_END, &entryS, sizeof(entryS)
-    );
-}
+//
+// Header preceding the saved TLB image
+//
+typedef struct tlbSaveHeaderS {
+    Uns32 version;      // image version (RISCV_TLB_VERSION)
+    Uns32 entrySize;    // size of each entry in the image
+    Uns32 num;          // number of entries in the image
+    Uns32 _u1;          // spare
+} tlbSaveHeader;
 
 //
 // Restore contents of one TLB entry
@@ -2866,26 +2924,55 @@ static void restoreTLBEntry(riscvTLBP tlb, tlbEntryP new) {
 }
 
 //
-// Save contents of the TLB
+// Save contents of the TLB as a single image (a header followed by a
+// contiguous array of all non-artifact entries) rather than element-by-element
 //
 static void saveTLB(riscvP riscv, riscvTLBP tlb, vmiSaveContextP cxt) {
 
-    // save all non-artifact TLB entries
+    tlbSaveHeader header = {
+        .version   = RISCV_TLB_VERSION,
+        .entrySize = sizeof(tlbEntry)
+    };
+
+    // count non-artifact TLB entries
     ITER_TLB_ENTRY_RANGE(
         riscv, tlb, 0, RISCV_MAX_ADDR, entry,
         if(!entry->artifact) {
-            saveTLBEntry(cxt, entry);
+            header.num++;
         }
     );
 
-    // save terminator
-    vmirtSaveElement(cxt, RISCV_TLB_ENTRY, RISCV_TLB_END, 0, 0);
+    vmirtSave(cxt, RISCV_TLB_HEADER, &header, sizeof(header));
+
+    if(header.num) {
+
+        tlbEntryP entries = STYPE_CALLOC_N(tlbEntry, header.num);
+        Uns32     i       = 0;
+
+        // fill image, clearing down properties used to manage mapping
+        ITER_TLB_ENTRY_RANGE(
+            riscv, tlb, 0, RISCV_MAX_ADDR, entry,
+            if(!entry->artifact) {
+                entries[i]          = *entry;
+                entries[i].isMapped = 0;
+                entries[i].lutEntry = 0;
+                i++;
+            }
+        );
+
+        vmirtSave(
+            cxt, RISCV_TLB_ENTRIES, entries, header.num*sizeof(tlbEntry)
+        );
+
+        STYPE_FREE(entries);
+    }
 }
 
 //
-// Restore contents of the TLB
+// Restore contents of the TLB saved element-by-element by previous versions of
+// the model (a sequence of TLB_ENTRY elements terminated by TLB_END)
 //
-static void restoreTLB(riscvP riscv, riscvTLBP tlb, vmiRestoreContextP cxt) {
+static void restoreTLBElements(riscvTLBP tlb, vmiRestoreContextP cxt) {
 
     tlbEntry new;
 
@@ -2899,6 +2986,57 @@ static void restoreTLB(riscvP riscv, riscvTLBP tlb, vmiRestoreContextP cxt) {
     }
 }
 
+//
+// Restore contents of the TLB from a single image
+//
+static void restoreTLB(riscvP riscv, riscvTLBP tlb, vmiRestoreContextP cxt) {
+
+    tlbSaveHeader header = {0};
+
+    if(vmirtRestore(cxt, RISCV_TLB_HEADER, &header, sizeof(header))!=SRS_OK) {
+
+        // no header, so TLB was saved element-by-element
+        restoreTLBElements(tlb, cxt);
+
+    } else if(header.num) {
+
+        Uns32 bytes = header.num*header.entrySize;
+        Uns8 *image = STYPE_CALLOC_N(Uns8, bytes);
+
+        // the image is always read, even if incompatible, so that state saved
+        // after it is restored from the correct position
+        if(vmirtRestore(cxt, RISCV_TLB_ENTRIES, image, bytes)!=SRS_OK) {
+
+            vmiMessage("W", CPU_PREFIX "_TLBR",
+                "TLB image could not be read - TLB not restored"
+            );
+
+        } else if(
+            (header.version!=RISCV_TLB_VERSION) ||
+            (header.entrySize!=sizeof(tlbEntry))
+        ) {
+
+            vmiMessage("W", CPU_PREFIX "_TLBV",
+                "Incompatible TLB image (version %u, entry size %u) - "
+                "TLB not restored",
+                header.version, header.entrySize
+            );
+
+        } else {
+
+            tlbEntryP entries = (tlbEntryP)image;
+            Uns32     i;
+
+            // restore all TLB entries
+            for(i=0; i<header.num; i++) {
+                restoreTLBEntry(tlb, &entries[i]);
+            }
+        }
+
+        STYPE_FREE(image);
+    }
+}
+
 //
 // Save VM state
 //